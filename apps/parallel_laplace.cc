@@ -73,7 +73,7 @@ namespace LA
 
 #include "parsed_grid_generator.h"
 #include "parsed_finite_element.h"
-#include "parsed_function.h"
+#include "parsed_batch_function.h"
 #include "parsed_dirichlet_bcs.h"
 #include "parsed_data_out.h"
 #include "utilities.h"
@@ -127,7 +127,7 @@ namespace ParallelLaplace
     // Collection of parsed_* objects
     ParsedGridGenerator<dim,dim> tria_builder;
     ParsedFiniteElement<dim,dim> fe_builder;
-    ParsedFunction<dim> forcing_function;
+    ParameterAcceptorProxy<ParsedBatchFunction<dim> > forcing_function;
     ParsedDirichletBCs<dim,dim,1> dirichlet_bcs;
     ParsedDataOut<dim,dim> data_out;
   };
@@ -226,6 +226,7 @@ namespace ParallelLaplace
     Vector<double>       cell_rhs (dofs_per_cell);
 
     std::vector<types::global_dof_index> local_dof_indices (dofs_per_cell);
+    std::vector<double>  rhs_values (n_q_points);
 
     typename DoFHandler<dim>::active_cell_iterator
     cell = dof_handler->begin_active(),
@@ -237,11 +238,12 @@ namespace ParallelLaplace
           cell_rhs = 0;
 
           fe_values.reinit (cell);
+          forcing_function.value_list (fe_values.get_quadrature_points(),
+                                       rhs_values);
 
           for (unsigned int q_point=0; q_point<n_q_points; ++q_point)
             {
-              const double rhs_value =
-                forcing_function.value(fe_values.quadrature_point(q_point));
+              const double rhs_value = rhs_values[q_point];
 
               for (unsigned int i=0; i<dofs_per_cell; ++i)
                 {
@@ -152,9 +152,7 @@ void SerialLaplace<dim>::make_grid_fe ()
 {
 
 
-  triangulation = SP(tria_builder.serial());
-
-  triangulation->refine_global(initial_refinement);
+  triangulation = SP(tria_builder.serial(initial_refinement));
 
   dof_handler = SP(new DoFHandler<dim>(*triangulation));
 
@@ -36,10 +36,10 @@
 #  include <deal2lkit/error_handler.h>
 #  include <deal2lkit/ida_interface.h>
 #  include <deal2lkit/parameter_acceptor.h>
+#  include <deal2lkit/parsed_batch_function.h>
 #  include <deal2lkit/parsed_data_out.h>
 #  include <deal2lkit/parsed_dirichlet_bcs.h>
 #  include <deal2lkit/parsed_finite_element.h>
-#  include <deal2lkit/parsed_function.h>
 #  include <deal2lkit/parsed_grid_generator.h>
 #  include <deal2lkit/parsed_grid_refinement.h>
 #  include <deal2lkit/parsed_solver.h>
@@ -177,12 +177,12 @@ private:
   ParsedGridRefinement          pgr;
   ParsedFiniteElement<dim, dim> fe_builder;
 
-  ParsedFunction<dim> exact_solution;
-  ParsedFunction<dim> forcing_term;
+  ParameterAcceptorProxy<ParsedBatchFunction<dim>> exact_solution;
+  ParameterAcceptorProxy<ParsedBatchFunction<dim>> forcing_term;
 
-  ParsedFunction<dim>          initial_solution;
-  ParsedFunction<dim>          initial_solution_dot;
-  ParsedDirichletBCs<dim, dim> dirichlet_bcs;
+  ParameterAcceptorProxy<ParsedBatchFunction<dim>> initial_solution;
+  ParameterAcceptorProxy<ParsedBatchFunction<dim>> initial_solution_dot;
+  ParsedDirichletBCs<dim, dim>                     dirichlet_bcs;
 
   ParsedDataOut<dim, dim> data_out;
 
@@ -119,10 +119,9 @@ template <int dim>
 void
 Heat<dim>::make_grid_fe()
 {
-  triangulation = SP(pgg.distributed(comm));
+  triangulation = SP(pgg.distributed(comm, initial_global_refinement));
   dof_handler   = SP(new DoFHandler<dim>(*triangulation));
   fe            = SP(fe_builder());
-  triangulation->refine_global(initial_global_refinement);
 }
 
 
@@ -201,14 +200,8 @@ Heat<dim>::assemble_jacobian_matrix(const double t,
 {
   computing_timer.enter_section("   Assemble jacobian matrix");
   jacobian_matrix = 0;
-  dirichlet_bcs.set_time(t);
+  dirichlet_bcs.update_inhomogeneities(t, constraints);
   exact_solution.set_time(t);
-  constraints.clear();
-  DoFTools::make_hanging_node_constraints(*dof_handler, constraints);
-
-  dirichlet_bcs.interpolate_boundary_values(*dof_handler, constraints);
-
-  constraints.close();
 
   VEC tmp(solution);
   constraints.distribute(tmp);
@@ -286,15 +279,9 @@ Heat<dim>::residual(const double t,
                     VEC &        dst)
 {
   computing_timer.enter_section("Residual");
-  dirichlet_bcs.set_time(t);
+  dirichlet_bcs.update_inhomogeneities(t, constraints);
   forcing_term.set_time(t);
   exact_solution.set_time(t);
-  constraints.clear();
-  DoFTools::make_hanging_node_constraints(*dof_handler, constraints);
-
-  dirichlet_bcs.interpolate_boundary_values(*dof_handler, constraints);
-
-  constraints.close();
 
   VEC tmp(solution);
   constraints.distribute(tmp);
@@ -318,6 +305,9 @@ Heat<dim>::residual(const double t,
 
   std::vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
 
+  std::vector<Point<dim>> quad_points(n_q_points);
+  std::vector<double>     forcing_values(n_q_points);
+
   const FEValuesExtractors::Scalar u(0);
 
   typename DoFHandler<dim>::active_cell_iterator cell =
@@ -331,10 +321,10 @@ Heat<dim>::residual(const double t,
         fe_values.reinit(cell);
         cell->get_dof_indices(local_dof_indices);
 
-        std::vector<Point<dim>> quad_points(n_q_points);
-
         quad_points = fe_values.get_quadrature_points();
 
+        forcing_term.value_list(quad_points, forcing_values);
+
         double         sol_dot;
         Tensor<1, dim> grad_sol;
 
@@ -360,8 +350,7 @@ Heat<dim>::residual(const double t,
 
                    + diffusivity * grad_sol * fe_values.shape_grad(i, q_point)
 
-                   - forcing_term.value(quad_points[q_point]) *
-                       fe_values.shape_value(i, q_point)
+                   - forcing_values[q_point] * fe_values.shape_value(i, q_point)
 
                      ) *
                   fe_values.JxW(q_point);
@@ -411,15 +400,9 @@ Heat<dim>::output_step(const double       t,
                        const unsigned int step_number)
 {
   computing_timer.enter_section("Postprocessing");
-  dirichlet_bcs.set_time(t);
+  dirichlet_bcs.update_inhomogeneities(t, constraints);
   forcing_term.set_time(t);
   exact_solution.set_time(t);
-  constraints.clear();
-  DoFTools::make_hanging_node_constraints(*dof_handler, constraints);
-
-  dirichlet_bcs.interpolate_boundary_values(*dof_handler, constraints);
-
-  constraints.close();
   VEC tmp(solution);
   constraints.distribute(tmp);
   distributed_solution     = tmp;
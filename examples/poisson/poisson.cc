@@ -107,13 +107,12 @@ main(int argc, char **argv)
   // Generate Triangulation, DoFHandler, and FE
   ParameterAcceptor::initialize("poisson.prm", "used_parameters.prm");
 
-  tria = SP(pgg.serial());
+  tria = SP(pgg.serial(par.initial_refinement));
   pgg.write(*tria);
 
   fe = SP(pfe());
   DoFHandler<dim, spacedim> dh(*tria);
 
-  tria->refine_global(par.initial_refinement);
   QGauss<dim> quad(2 * fe->degree + 1);
 
   for (unsigned int i = 0; i < par.n_cycles; ++i)
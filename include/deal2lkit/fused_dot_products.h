@@ -0,0 +1,274 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+#ifndef d2k_fused_dot_products_h
+#define d2k_fused_dot_products_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal2lkit/config.h>
+
+#ifdef DEAL_II_WITH_TRILINOS
+#  include <deal.II/lac/trilinos_parallel_block_vector.h>
+#  include <deal.II/lac/trilinos_vector.h>
+
+#  include <Epetra_MultiVector.h>
+#endif
+
+#include <utility>
+#include <vector>
+
+
+
+D2K_NAMESPACE_OPEN
+
+/**
+ * A set of scalar products computed with a single global reduction,
+ * which can be overlapped with other work. The pairs of vectors are
+ * queued with add(), the reduction is started with start(), and the
+ * results are collected with finish():
+ *
+ * @code
+ * FusedDotProducts<VEC> dots;
+ * dots.add(r, u);
+ * dots.add(w, u);
+ * dots.start();
+ * A.vmult(n, m); // overlapped with the reduction
+ * const std::vector<double> gamma_delta = dots.finish();
+ * @endcode
+ *
+ * For LinearAlgebra::distributed::Vector and for the Trilinos vectors
+ * and block vectors, the local contributions are summed with one
+ * non-blocking MPI_Iallreduce. For all the other vector types the
+ * scalar products are computed by start(), one by one, each with its
+ * own blocking reduction.
+ */
+template <typename VECTOR>
+class FusedDotProducts
+{
+public:
+  /**
+   * Queue the scalar product of @p a and @p b. The vectors must not be
+   * changed until start() is called.
+   */
+  void
+  add(const VECTOR &a, const VECTOR &b)
+  {
+    pairs.emplace_back(&a, &b);
+  }
+
+  /**
+   * Compute the queued scalar products.
+   */
+  void
+  start()
+  {
+    results.resize(pairs.size());
+    for (unsigned int i = 0; i < pairs.size(); ++i)
+      results[i] = (*pairs[i].first) * (*pairs[i].second);
+    pairs.clear();
+  }
+
+  /**
+   * Return the scalar products, in the order in which they were queued.
+   */
+  std::vector<double>
+  finish()
+  {
+    return std::move(results);
+  }
+
+private:
+  std::vector<std::pair<const VECTOR *, const VECTOR *>> pairs;
+  std::vector<double>                                    results;
+};
+
+
+namespace internal
+{
+  /**
+   * Sum of the products of the locally owned entries of @p a and @p b.
+   */
+  template <typename Number>
+  double
+  local_dot(const dealii::LinearAlgebra::distributed::Vector<Number> &a,
+            const dealii::LinearAlgebra::distributed::Vector<Number> &b)
+  {
+    AssertDimension(a.locally_owned_size(), b.locally_owned_size());
+    double sum = 0;
+    for (unsigned int k = 0; k < a.locally_owned_size(); ++k)
+      sum += a.local_element(k) * b.local_element(k);
+    return sum;
+  }
+
+  template <typename Number>
+  MPI_Comm
+  communicator(const dealii::LinearAlgebra::distributed::Vector<Number> &v)
+  {
+    return v.get_mpi_communicator();
+  }
+
+#ifdef DEAL_II_WITH_TRILINOS
+  inline double
+  local_dot(const dealii::TrilinosWrappers::MPI::Vector &a,
+            const dealii::TrilinosWrappers::MPI::Vector &b)
+  {
+    Assert(!a.has_ghost_elements() && !b.has_ghost_elements(),
+           dealii::ExcMessage("Scalar products of ghosted vectors are not "
+                              "allowed."));
+    const Epetra_MultiVector &ea = a.trilinos_vector();
+    const Epetra_MultiVector &eb = b.trilinos_vector();
+    AssertDimension(ea.MyLength(), eb.MyLength());
+    double sum = 0;
+    for (int k = 0; k < ea.MyLength(); ++k)
+      sum += ea[0][k] * eb[0][k];
+    return sum;
+  }
+
+  inline MPI_Comm
+  communicator(const dealii::TrilinosWrappers::MPI::Vector &v)
+  {
+    return v.get_mpi_communicator();
+  }
+
+  inline double
+  local_dot(const dealii::TrilinosWrappers::MPI::BlockVector &a,
+            const dealii::TrilinosWrappers::MPI::BlockVector &b)
+  {
+    AssertDimension(a.n_blocks(), b.n_blocks());
+    double sum = 0;
+    for (unsigned int i = 0; i < a.n_blocks(); ++i)
+      sum += local_dot(a.block(i), b.block(i));
+    return sum;
+  }
+
+  inline MPI_Comm
+  communicator(const dealii::TrilinosWrappers::MPI::BlockVector &v)
+  {
+    return communicator(v.block(0));
+  }
+#endif
+
+  /**
+   * Implementation of FusedDotProducts for the vector types for which
+   * local_dot() and communicator() are defined: the local contributions
+   * are computed by start(), and summed with one non-blocking
+   * MPI_Iallreduce.
+   */
+  template <typename VECTOR>
+  class NonBlockingDotProducts
+  {
+  public:
+    void
+    add(const VECTOR &a, const VECTOR &b)
+    {
+      pairs.emplace_back(&a, &b);
+    }
+
+    void
+    start()
+    {
+      results.resize(pairs.size());
+      for (unsigned int i = 0; i < pairs.size(); ++i)
+        results[i] = local_dot(*pairs[i].first, *pairs[i].second);
+
+#ifdef DEAL_II_WITH_MPI
+      if (pairs.size() > 0)
+        {
+          const int ierr = MPI_Iallreduce(MPI_IN_PLACE,
+                                          results.data(),
+                                          results.size(),
+                                          MPI_DOUBLE,
+                                          MPI_SUM,
+                                          communicator(*pairs[0].first),
+                                          &request);
+          AssertThrowMPI(ierr);
+          pending = true;
+        }
+#endif
+      pairs.clear();
+    }
+
+    std::vector<double>
+    finish()
+    {
+#ifdef DEAL_II_WITH_MPI
+      if (pending)
+        {
+          const int ierr = MPI_Wait(&request, MPI_STATUS_IGNORE);
+          AssertThrowMPI(ierr);
+          pending = false;
+        }
+#endif
+      return std::move(results);
+    }
+
+  private:
+    std::vector<std::pair<const VECTOR *, const VECTOR *>> pairs;
+    std::vector<double>                                    results;
+
+#ifdef DEAL_II_WITH_MPI
+    MPI_Request request;
+    bool        pending = false;
+#endif
+  };
+} // namespace internal
+
+
+/**
+ * Specialization for LinearAlgebra::distributed::Vector, which starts a
+ * non-blocking reduction of the local contributions.
+ */
+template <typename Number>
+class FusedDotProducts<dealii::LinearAlgebra::distributed::Vector<Number>>
+  : public internal::NonBlockingDotProducts<
+      dealii::LinearAlgebra::distributed::Vector<Number>>
+{};
+
+
+#ifdef DEAL_II_WITH_TRILINOS
+/**
+ * Specialization for TrilinosWrappers::MPI::Vector, which starts a
+ * non-blocking reduction of the local contributions of the underlying
+ * Epetra_MultiVector.
+ */
+template <>
+class FusedDotProducts<dealii::TrilinosWrappers::MPI::Vector>
+  : public internal::NonBlockingDotProducts<
+      dealii::TrilinosWrappers::MPI::Vector>
+{};
+
+
+/**
+ * Specialization for TrilinosWrappers::MPI::BlockVector, which starts a
+ * single non-blocking reduction of the local contributions of all the
+ * blocks.
+ */
+template <>
+class FusedDotProducts<dealii::TrilinosWrappers::MPI::BlockVector>
+  : public internal::NonBlockingDotProducts<
+      dealii::TrilinosWrappers::MPI::BlockVector>
+{};
+#endif
+
+D2K_NAMESPACE_CLOSE
+
+
+#endif
@@ -0,0 +1,248 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+#ifndef d2k_parsed_batch_function_h
+#define d2k_parsed_batch_function_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/parameter_handler.h>
+#include <deal.II/base/parsed_function.h>
+#include <deal.II/base/point.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal2lkit/config.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+
+
+D2K_NAMESPACE_OPEN
+
+/**
+ * An expression in the muParser syntax, compiled to the bytecode of a
+ * stack machine which evaluates it at many points at once.
+ *
+ * The values of the variables are given as one array per variable
+ * (structure of arrays). The points are processed in batches of
+ * batch_size: every instruction of the bytecode is applied to a whole
+ * batch with a loop that the compiler can vectorize, instead of
+ * interpreting the whole expression once per point. Constant
+ * subexpressions are folded at compile time, and the powers with a small
+ * integer exponent, like x^2, are computed by multiplications instead of
+ * calls to std::pow().
+ *
+ * The numbers, the variables and the constants, the arithmetic,
+ * comparison and logical operators, the ternary operator `?:`, and the
+ * most common functions of muParser and of dealii::FunctionParser are
+ * supported. initialize() returns false for everything else (e.g., for
+ * rand()), in which case the expression must be evaluated by
+ * dealii::FunctionParser.
+ */
+class BatchExpression
+{
+public:
+  /**
+   * Number of points evaluated by each pass over the bytecode.
+   */
+  static const unsigned int batch_size = 64;
+
+  /**
+   * Compile @p expression, where the names in @p variables denote the
+   * arrays passed to evaluate(), in the same order, and the names in
+   * @p constants are replaced by their values. Return false, leaving the
+   * object empty, if the expression contains something which is not
+   * supported.
+   */
+  bool
+  initialize(const std::string &                  expression,
+             const std::vector<std::string> &     variables,
+             const std::map<std::string, double> &constants);
+
+  /**
+   * Return true if initialize() succeeded.
+   */
+  bool
+  is_initialized() const;
+
+  /**
+   * Evaluate the expression at @p n_points points, where @p variables[v]
+   * points to the @p n_points values of the v-th variable, and store the
+   * results in @p result.
+   */
+  void
+  evaluate(const std::vector<const double *> &variables,
+           const unsigned int                 n_points,
+           double *                           result) const;
+
+private:
+  /**
+   * The instructions of the stack machine. Except for push_constant and
+   * push_variable, they replace the operands on top of the stack with
+   * the result. integer_power raises the top of the stack to the integer
+   * exponent stored in the value of the instruction.
+   */
+  enum Operation
+  {
+    push_constant,
+    push_variable,
+    add,
+    subtract,
+    multiply,
+    divide,
+    power,
+    integer_power,
+    negate,
+    less,
+    greater,
+    less_equal,
+    greater_equal,
+    equal,
+    not_equal,
+    logical_and,
+    logical_or,
+    select,
+    minimum,
+    maximum,
+    sin,
+    cos,
+    tan,
+    asin,
+    acos,
+    atan,
+    sinh,
+    cosh,
+    tanh,
+    asinh,
+    acosh,
+    atanh,
+    exp,
+    log,
+    log2,
+    log10,
+    sqrt,
+    abs,
+    sign,
+    rint,
+    floor,
+    ceil,
+    cot,
+    sec,
+    csc,
+    erfc
+  };
+
+  struct Instruction
+  {
+    Operation    operation;
+    unsigned int variable;
+    double       value;
+  };
+
+  class Compiler;
+
+  /**
+   * Number of operands of @p operation.
+   */
+  static unsigned int
+  n_operands(const Operation operation);
+
+  /**
+   * Apply @p operation to a single value, or to a pair of values, of the
+   * batch. Used for constant folding.
+   */
+  static double
+  apply(const Operation operation, const double *operands);
+
+  std::vector<Instruction> program;
+
+  /**
+   * Maximum depth of the stack during the execution of program.
+   */
+  unsigned int stack_size = 0;
+};
+
+
+/**
+ * A dealii::Functions::ParsedFunction whose value_list() and
+ * vector_value_list() evaluate the expressions of all the points with a
+ * BatchExpression, instead of calling the muParser of
+ * dealii::FunctionParser once per point and per component.
+ *
+ * The parameters are the ones of dealii::Functions::ParsedFunction. If
+ * some of the expressions can not be compiled to a BatchExpression, all
+ * the member functions fall back to the ones of the base class.
+ */
+template <int spacedim>
+class ParsedBatchFunction : public dealii::Functions::ParsedFunction<spacedim>
+{
+public:
+  /**
+   * Constructor.
+   */
+  ParsedBatchFunction(const unsigned int n_components = 1,
+                      const double       h            = 1e-8);
+
+  /**
+   * Parse the parameters as dealii::Functions::ParsedFunction, and
+   * compile the expressions.
+   */
+  void
+  parse_parameters(dealii::ParameterHandler &prm);
+
+  /**
+   * Return true if the expressions are evaluated by BatchExpression
+   * objects.
+   */
+  bool
+  is_batched() const;
+
+  virtual void
+  value_list(const std::vector<dealii::Point<spacedim>> &points,
+             std::vector<double> &                       values,
+             const unsigned int component = 0) const override;
+
+  virtual void
+  vector_value_list(
+    const std::vector<dealii::Point<spacedim>> &points,
+    std::vector<dealii::Vector<double>> &       values) const override;
+
+private:
+  /**
+   * Values of the variables (the coordinates, and the time if it is
+   * used) at the @p points, one array per variable.
+   */
+  void
+  fill_variables(const std::vector<dealii::Point<spacedim>> &points,
+                 std::vector<std::vector<double>> &          variables) const;
+
+  /**
+   * One expression per component, empty if they are not batched.
+   */
+  std::vector<BatchExpression> expressions;
+
+  /**
+   * Whether the last variable is the time.
+   */
+  bool time_dependent = false;
+};
+
+D2K_NAMESPACE_CLOSE
+
+
+#endif
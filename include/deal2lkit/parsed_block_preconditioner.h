@@ -0,0 +1,326 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+#ifndef d2k_parsed_block_preconditioner_h
+#define d2k_parsed_block_preconditioner_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/lac/block_linear_operator.h>
+#include <deal.II/lac/linear_operator.h>
+#include <deal.II/lac/vector_memory.h>
+
+#include <deal2lkit/config.h>
+#include <deal2lkit/parameter_acceptor.h>
+#include <deal2lkit/parsed_solver.h>
+#include <deal2lkit/utilities.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+
+D2K_NAMESPACE_OPEN
+
+/**
+ * A block preconditioner for saddle point and multiphysics systems,
+ * which uses parameter files to choose between different options. This
+ * object is a LinearOperator which can be used as the preconditioner of
+ * a ParsedSolver acting on block vectors.
+ *
+ * The blocks are named after the blocks of a ParsedFiniteElement, i.e.,
+ * after the string returned by ParsedFiniteElement::get_block_names().
+ * For every block, the inverse of an approximation of its diagonal
+ * block (for example the (0,0) block of the system, or a mass matrix
+ * approximating a Schur complement) is applied through an inner
+ * ParsedSolver, declared in the subsection "Inner solver <block name>",
+ * and preconditioned by an operator supplied by the user, for example
+ * a ParsedAMGPreconditioner. For the blocks listed in "Preconditioner
+ * only blocks", the inner solve is replaced by a single application of
+ * the preconditioner.
+ *
+ * The inverses of the diagonal blocks are combined according to the
+ * "Structure" parameter:
+ * - "diagonal": block Jacobi;
+ * - "upper": block upper triangular, obtained by back substitution
+ *   with the upper off-diagonal blocks of the system;
+ * - "lower": block lower triangular, obtained by forward substitution
+ *   with the lower off-diagonal blocks of the system;
+ * - "full schur": the inverse of the block LDU factorization of a two
+ *   by two block system, where the second diagonal block approximates
+ *   the Schur complement.
+ *
+ * Example usage for a Stokes problem is the following:
+ *
+ * @code
+ * ParsedFiniteElement<dim> fe("FE", "FESystem[FE_Q(2)^d-FE_Q(1)]",
+ *                             "u,u,p");
+ * ParsedBlockPreconditioner<BVEC> P("Block prec", fe.get_block_names());
+ * ParsedSolver<BVEC> Ainv("Solver", "fgmres");
+ * ParameterAcceptor::initialize(...);
+ *
+ * P.initialize_preconditioner(
+ *   block_operator<BVEC>(system_matrix),
+ *   {linear_operator<VEC>(system_matrix.block(0, 0)),
+ *    -1.0 * linear_operator<VEC>(mass_matrix.block(1, 1))},
+ *   {linear_operator<VEC>(system_matrix.block(0, 0), amg),
+ *    linear_operator<VEC>(mass_matrix.block(1, 1), jacobi)});
+ * Ainv.prec = P;
+ * @endcode
+ *
+ * The inner solvers, and the scratch vectors taken from a
+ * dealii::GrowingVectorMemory pool, are reused by all the applications
+ * of the preconditioner.
+ */
+template <typename BVEC>
+class ParsedBlockPreconditioner : public dealii::LinearOperator<BVEC, BVEC>,
+                                  public ParameterAcceptor
+{
+public:
+  /**
+   * Type of the blocks of the vectors.
+   */
+  using VEC = typename BVEC::BlockType;
+
+  /**
+   * Constructor. The @p block_names are a comma separated list, as
+   * returned by ParsedFiniteElement::get_block_names(). The default
+   * structure, and the default inner solver, its maximum number of
+   * iterations and its reduction are used for all the blocks.
+   */
+  ParsedBlockPreconditioner(const std::string &name              = "",
+                            const std::string &block_names       = "u,p",
+                            const std::string &default_structure = "upper",
+                            const std::string &inner_solver      = "cg",
+                            const unsigned int inner_iter        = 1000,
+                            const double       inner_reduction   = 1e-8);
+
+  /**
+   * Declare the structure of the preconditioner.
+   */
+  virtual void
+  declare_parameters(dealii::ParameterHandler &prm);
+
+  /**
+   * Build the preconditioner. The off-diagonal blocks are taken from
+   * the @p system. For every block, @p diagonal contains the operator
+   * inverted by the inner solver, and @p preconditioners the operator
+   * used to precondition it.
+   */
+  void
+  initialize_preconditioner(
+    const dealii::BlockLinearOperator<BVEC> &        system,
+    const std::vector<dealii::LinearOperator<VEC>> &diagonal,
+    const std::vector<dealii::LinearOperator<VEC>> &preconditioners);
+
+  /**
+   * The inner solver of the given @p block. It can be used, e.g., to
+   * query the number of inner iterations.
+   */
+  ParsedSolver<VEC> &
+  get_inner_solver(const unsigned int block);
+
+private:
+  /**
+   * Names of the blocks.
+   */
+  std::vector<std::string> block_names;
+
+  /**
+   * Structure of the preconditioner: "diagonal", "upper", "lower" or
+   * "full schur".
+   */
+  std::string structure;
+
+  /**
+   * Blocks for which the inner solve is replaced by a single
+   * application of the preconditioner.
+   */
+  std::vector<std::string> preconditioner_only_blocks;
+
+  /**
+   * One inner solver per block.
+   */
+  std::vector<std::unique_ptr<ParsedSolver<VEC>>> inner_solvers;
+};
+
+// ============================================================
+// Explicit template functions
+// ============================================================
+
+template <typename BVEC>
+ParsedBlockPreconditioner<BVEC>::ParsedBlockPreconditioner(
+  const std::string &name,
+  const std::string &block_names,
+  const std::string &default_structure,
+  const std::string &inner_solver,
+  const unsigned int inner_iter,
+  const double       inner_reduction)
+  : ParameterAcceptor(name)
+  , block_names(dealii::Utilities::split_string_list(block_names))
+  , structure(default_structure)
+{
+  for (const auto &block : this->block_names)
+    inner_solvers.emplace_back(
+      new ParsedSolver<VEC>(name + "/Inner solver " + block,
+                            inner_solver,
+                            inner_iter,
+                            inner_reduction));
+}
+
+
+template <typename BVEC>
+void
+ParsedBlockPreconditioner<BVEC>::declare_parameters(
+  dealii::ParameterHandler &prm)
+{
+  add_parameter(
+    prm,
+    &structure,
+    "Structure",
+    structure,
+    dealii::Patterns::Selection("diagonal|upper|lower|full schur"),
+    "How the inverses of the diagonal blocks are combined: block\n"
+    "diagonal, block upper or lower triangular, or the inverse of the\n"
+    "block LDU factorization of a two by two system (full schur).");
+
+  add_parameter(prm,
+                &preconditioner_only_blocks,
+                "Preconditioner only blocks",
+                "",
+                dealii::Patterns::List(dealii::Patterns::Anything()),
+                "Blocks for which the inner solve is replaced by a single\n"
+                "application of the preconditioner.");
+}
+
+
+template <typename BVEC>
+ParsedSolver<typename ParsedBlockPreconditioner<BVEC>::VEC> &
+ParsedBlockPreconditioner<BVEC>::get_inner_solver(const unsigned int block)
+{
+  AssertIndexRange(block, inner_solvers.size());
+  return *inner_solvers[block];
+}
+
+
+template <typename BVEC>
+void
+ParsedBlockPreconditioner<BVEC>::initialize_preconditioner(
+  const dealii::BlockLinearOperator<BVEC> &        system,
+  const std::vector<dealii::LinearOperator<VEC>> &diagonal,
+  const std::vector<dealii::LinearOperator<VEC>> &preconditioners)
+{
+  const unsigned int n_blocks = block_names.size();
+  AssertDimension(system.n_block_rows(), n_blocks);
+  AssertDimension(system.n_block_cols(), n_blocks);
+  AssertDimension(diagonal.size(), n_blocks);
+  AssertDimension(preconditioners.size(), n_blocks);
+  AssertThrow(structure != "full schur" || n_blocks == 2,
+              dealii::ExcMessage("The full schur structure is only "
+                                 "available for two by two block systems."));
+
+  std::vector<dealii::LinearOperator<VEC>> inverse(n_blocks);
+  for (unsigned int i = 0; i < n_blocks; ++i)
+    if (std::find(preconditioner_only_blocks.begin(),
+                  preconditioner_only_blocks.end(),
+                  block_names[i]) != preconditioner_only_blocks.end())
+      inverse[i] = preconditioners[i];
+    else
+      {
+        inner_solvers[i]->op   = diagonal[i];
+        inner_solvers[i]->prec = preconditioners[i];
+        inverse[i]             = *inner_solvers[i];
+      }
+
+  std::vector<std::vector<dealii::LinearOperator<VEC>>> blocks(n_blocks);
+  for (unsigned int i = 0; i < n_blocks; ++i)
+    for (unsigned int j = 0; j < n_blocks; ++j)
+      blocks[i].push_back(system.block(i, j));
+
+  // Apply the preconditioner to src, storing the result in dst. The
+  // substitutions are the ones with the block triangular parts of the
+  // system.
+  const auto apply = [blocks, inverse, type = structure, n_blocks](
+                       BVEC &dst, const BVEC &src) {
+    dealii::GrowingVectorMemory<VEC>            vector_memory;
+    typename dealii::VectorMemory<VEC>::Pointer rhs(vector_memory);
+    typename dealii::VectorMemory<VEC>::Pointer product(vector_memory);
+
+    const auto substitute = [&](const unsigned int i, const bool upper) {
+      inverse[i].reinit_range_vector(*rhs, true);
+      *rhs = src.block(i);
+      for (unsigned int j = 0; j < n_blocks; ++j)
+        if ((upper && j > i) || (!upper && j < i))
+          {
+            blocks[i][j].reinit_range_vector(*product, true);
+            blocks[i][j].vmult(*product, dst.block(j));
+            *rhs -= *product;
+          }
+      inverse[i].vmult(dst.block(i), *rhs);
+    };
+
+    if (type == "diagonal")
+      for (unsigned int i = 0; i < n_blocks; ++i)
+        inverse[i].vmult(dst.block(i), src.block(i));
+    else if (type == "lower")
+      for (unsigned int i = 0; i < n_blocks; ++i)
+        substitute(i, false);
+    else if (type == "upper")
+      for (unsigned int i = n_blocks; i-- > 0;)
+        substitute(i, true);
+    else
+      {
+        // Inverse of L D U: the forward substitution applies the inverse
+        // of L D, the correction of the first block the one of U.
+        substitute(0, false);
+        substitute(1, false);
+        blocks[0][1].reinit_range_vector(*rhs, true);
+        blocks[0][1].vmult(*rhs, dst.block(1));
+        inverse[0].reinit_range_vector(*product, true);
+        inverse[0].vmult(*product, *rhs);
+        dst.block(0) -= *product;
+      }
+  };
+
+  dealii::LinearOperator<BVEC, BVEC> &op = *this;
+  op = system;
+
+  op.vmult = apply;
+
+  op.vmult_add = [apply](BVEC &dst, const BVEC &src) {
+    dealii::GrowingVectorMemory<BVEC>            vector_memory;
+    typename dealii::VectorMemory<BVEC>::Pointer tmp(vector_memory);
+    tmp->reinit(dst, true);
+    apply(*tmp, src);
+    dst += *tmp;
+  };
+
+  op.Tvmult = [](BVEC &, const BVEC &) {
+    Assert(false, dealii::ExcNotImplemented());
+  };
+
+  op.Tvmult_add = [](BVEC &, const BVEC &) {
+    Assert(false, dealii::ExcNotImplemented());
+  };
+}
+
+D2K_NAMESPACE_CLOSE
+
+
+#endif
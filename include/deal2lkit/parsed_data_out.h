@@ -18,6 +18,7 @@
 
 #include <deal.II/base/config.h>
 
+#include <deal.II/base/data_out_base.h>
 #include <deal.II/base/logstream.h>
 #include <deal.II/base/parameter_handler.h>
 
@@ -31,7 +32,13 @@
 #include <deal2lkit/parameter_acceptor.h>
 #include <deal2lkit/utilities.h>
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 D2K_NAMESPACE_OPEN
 
@@ -53,6 +60,12 @@ public:
                 const std::string & files_to_save          = "",
                 const MPI_Comm &    comm                   = MPI_COMM_WORLD);
 
+  /** Destructor. Wait for all pending asynchronous outputs to be
+      written, and stop the writer thread. Errors of the outputs which
+      were not reported by wait_for_pending_output() are printed to
+      std::cerr. */
+  ~ParsedDataOut();
+
   /** Initialize the given values for the paramter file. */
   virtual void
   declare_parameters(dealii::ParameterHandler &prm);
@@ -95,12 +108,76 @@ public:
       process can be started again.
       @p used_files is an optional variable that takes a list of useful files
       (ex. "parameter.prm time.dat") and copies these files
-      in the @p incremental_run_prefix of the costructor function.*/
+      in the @p incremental_run_prefix of the costructor function.
+
+      If "Asynchronous output" is set to true, only the patches are built
+      here, and the file is written by a background thread. Call
+      wait_for_pending_output() if you need the file on disk.*/
   void
   write_data_and_clear(const dealii::Mapping<dim, spacedim> &mapping =
                          dealii::StaticMappingQ1<dim, spacedim>::mapping);
 
+  /** Set the time associated to the next outputs. This is only used
+      by the hdf5 output format, where it is stored in the xdmf file. If
+      this function is never called, the progressive number of the
+      output is used instead. */
+  void
+  set_time(const double time);
+
+  /** Block until all the outputs queued by write_data_and_clear() in
+      asynchronous mode have been written to disk. If an error occurred
+      in the writer thread, it is rethrown here. In synchronous mode
+      this function returns immediately. */
+  void
+  wait_for_pending_output();
+
+  /** Tell this object that the geometry described by the mapping
+      passed to write_data_and_clear() changed, while the mapping object
+      itself did not, as it happens when the displacement vector of a
+      MappingQEulerian is updated. The cached patches and the hdf5 mesh
+      are identified by the address of the mapping, so without this call
+      the next output would reuse a stale geometry. */
+  void
+  invalidate_geometry();
+
 private:
+  /** Add a job to the queue of the writer thread, starting the thread
+      if necessary. If there are already @p max_pending_outputs
+      outputs in flight, wait until one of them is completed. */
+  void
+  enqueue_output(const std::function<void()> &job);
+
+  /** Main loop of the writer thread. */
+  void
+  writer_loop();
+
+  /** Build the patches of data_out. If "Cache patch geometry" is
+      true, and neither the triangulation, the mapping nor the
+      subdivisions changed since the last output, the patches are
+      built with a linear mapping, which is cheap, and their geometry
+      is taken from the cache. Otherwise, the patches are built from
+      scratch, and their geometry is stored in the cache. */
+  void
+  build_patches(const dealii::Mapping<dim, spacedim> &mapping);
+
+  /** Write the patches in the hdf5 format. The mesh is written only if
+      the triangulation or the mapping changed since the last output,
+      while the solution is written in a new file every time. The xdmf
+      file describing the whole time series is rewritten. */
+  void
+  write_hdf5_data(const dealii::Mapping<dim, spacedim> &mapping);
+
+  /** Return true if the vtu output of all processes is collected into
+      @p n_output_groups files. */
+  bool
+  grouped_output() const;
+
+  /** Name of the @p index-th of @p n_files output files. The numbers
+      use as many digits as needed by @p n_files, with a minimum of
+      two. */
+  std::string
+  output_file_name(const unsigned int index, const unsigned int n_files) const;
+
   /** Initialization flag.*/
   bool initialized;
 
@@ -154,6 +231,101 @@ private:
 
   /** Outputs only the data that refers to this process. */
   shared_ptr<dealii::DataOut<dim, spacedim>> data_out;
+
+  /** Number of output files requested in the parameter file. If zero,
+      every process writes its own file. */
+  unsigned int n_output_files;
+
+  /** Actual number of groups of processes writing a single vtu file
+      with MPI-IO. If zero, every process writes its own file. */
+  unsigned int n_output_groups;
+
+  /** The group of processes this process belongs to. */
+  unsigned int output_group;
+
+  /** Communicator of the processes of the same group. */
+  MPI_Comm group_comm;
+
+  /** True if the mesh has to be written at the next hdf5 output. */
+  bool mesh_changed;
+
+  /** Triangulation used in the last hdf5 or cached output. */
+  const dealii::Triangulation<dim, spacedim> *output_triangulation;
+
+  /** Mapping used in the last hdf5 output. */
+  const dealii::Mapping<dim, spacedim> *hdf5_mapping;
+
+  /** Connection to the any_change signal of output_triangulation. */
+  boost::signals2::connection tria_connection;
+
+  /** Number of meshes written in hdf5 format. */
+  unsigned int n_hdf5_meshes;
+
+  /** Name of the last hdf5 mesh file, relative to path_solution_dir. */
+  std::string hdf5_mesh_name;
+
+  /** All the entries of the xdmf file. */
+  std::vector<dealii::XDMFEntry> xdmf_entries;
+
+  /** Time set by set_time(). */
+  double output_time;
+
+  /** Whether set_time() has been called. */
+  bool output_time_set;
+
+  /** Reuse the geometry of the patches across outputs on the same
+      mesh. See build_patches(). */
+  bool cache_patches;
+
+  /** True if a DataPostprocessor was added to the current output.
+      Postprocessors may depend on the mapping, so the cache is not
+      used. */
+  bool has_postprocessed_data;
+
+  /** Geometry of the patches of the last output built from scratch:
+      the vertices and, for curved patches, the position of the
+      points. Empty if the cache is not valid. */
+  std::vector<dealii::DataOutBase::Patch<dim, spacedim>> cached_patches;
+
+  /** Mapping used to build cached_patches. */
+  const dealii::Mapping<dim, spacedim> *cached_mapping;
+
+  /** Subdivisions used to build cached_patches. */
+  unsigned int cached_subdivisions;
+
+  /** Write the output files in a background thread. The patches are
+      built by the calling thread, and write_data_and_clear() returns
+      as soon as they have been handed over to the writer thread. The
+      hdf5 and the grouped outputs are collective, and are always
+      written synchronously. */
+  bool asynchronous_output;
+
+  /** Maximum number of outputs that can be queued or being written by
+      the writer thread. This bounds the memory used by the copies of
+      the patches. */
+  unsigned int max_pending_outputs;
+
+  /** The writer thread. Started at the first asynchronous output. */
+  std::thread writer_thread;
+
+  /** Protects the queue and the state of the writer thread. */
+  std::mutex writer_mutex;
+
+  /** Signals changes in the queue and in the state of the writer
+      thread. */
+  std::condition_variable writer_condition;
+
+  /** Outputs waiting to be written. */
+  std::deque<std::function<void()>> pending_outputs;
+
+  /** True while the writer thread is writing an output. */
+  bool writing_output;
+
+  /** Ask the writer thread to terminate once the queue is empty. */
+  bool stop_writer;
+
+  /** Exception thrown while writing, rethrown in the calling thread. */
+  std::exception_ptr writer_exception;
 };
 
 
@@ -223,6 +395,7 @@ ParsedDataOut<dim, spacedim>::add_data_vector(
 {
   AssertThrow(initialized, dealii::ExcNotInitialized());
   data_out->add_data_vector(data_vector, postproc);
+  has_postprocessed_data = true;
 }
 
 D2K_NAMESPACE_CLOSE
@@ -17,6 +17,7 @@
 #define d2k_parsed_dirichlet_bcs_h
 
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/point.h>
 
 #include <deal.II/dofs/dof_handler.h>
 
@@ -48,6 +49,10 @@ namespace dealii
 #include <deal2lkit/parameter_acceptor.h>
 #include <deal2lkit/parsed_mapped_functions.h>
 
+#include <map>
+#include <utility>
+#include <vector>
+
 
 D2K_NAMESPACE_OPEN
 
@@ -60,7 +65,22 @@ D2K_NAMESPACE_OPEN
  *
  * The VectorTools::interpolate_boundary_values and
  * VectorTools::project_boundary_values functions of
- * the deal.II library have been wrapped.
+ * the deal.II library have been wrapped. The interpolation of the
+ * boundary values of all the ids is done with a single traversal of the
+ * boundary faces.
+ *
+ * For primitive finite elements, the projection of the boundary values
+ * is computed by this class, and works also with parallel::distributed
+ * triangulations: the local mass matrices of the locally owned boundary
+ * faces of all the ids are assembled by several threads in a single
+ * pass, the projection of each id is computed with a distributed
+ * conjugate gradient method, and the values of the locally relevant
+ * boundary dofs are returned. Only the components selected by the mask
+ * of each id are projected. As with VectorTools::project_boundary_values,
+ * the ids are projected independently, and a dof shared by several ids
+ * takes the value of the first id in an AffineConstraints object, and of
+ * the last one in a std::map. On meshes with hanging nodes on the
+ * boundary, VectorTools::project_boundary_values is called once per id.
  *
  *
  * A typical usage of this class is the following
@@ -202,6 +222,27 @@ public:
     const dealii::DoFHandler<dim, spacedim> &          dof_handler,
     std::map<dealii::types::global_dof_index, double> &d_dofs) const;
 
+  /**
+   * Set the time of the mapped functions to @p t, and update the
+   * inhomogeneities of the boundary constraints stored in @p constraints
+   * by the last call of interpolate_boundary_values() on an
+   * AffineConstraints object. Only the expressions are evaluated again:
+   * the boundary dofs and their support points are computed once per
+   * mesh, by interpolate_boundary_values(). The ids whose expressions do
+   * not depend on the time (see is_time_dependent()) keep their values.
+   * No constraint is added or removed, so that @p constraints does not
+   * have to be closed again.
+   *
+   * If @p constraints is closed, the inhomogeneities of the lines which
+   * were constrained to the boundary dofs when interpolate_boundary_values()
+   * was called (e.g., hanging nodes on the boundary) are updated as well.
+   * Constraints added after interpolate_boundary_values() must not depend
+   * on the boundary dofs.
+   */
+  void
+  update_inhomogeneities(const double                       t,
+                         dealii::AffineConstraints<double> &constraints);
+
   /**
    * This function must be called in order to apply the boundary conditions
    * to the AffineConstraints<double> .
@@ -320,10 +361,109 @@ public:
     dealii::AffineConstraints<double> &      constraints) const;
 
 private:
+  /**
+   * The boundary degrees of freedom of the mapped ids, with their
+   * components and support points. Every degree of freedom belongs to a
+   * single id, and is listed once, in ascending order within each id.
+   */
+  struct BoundaryDoFs
+  {
+    std::vector<unsigned int>                                 ids;
+    std::vector<std::vector<dealii::types::global_dof_index>> dofs;
+    std::vector<std::vector<unsigned int>>                    components;
+    std::vector<std::vector<dealii::Point<spacedim>>>         points;
+  };
+
+  /**
+   * Collect the boundary degrees of freedom of all the mapped ids with a
+   * single traversal of the boundary faces. Only the components selected
+   * by the mask of each id are considered. A degree of freedom shared by
+   * faces with different ids is assigned to the first id returned by
+   * get_mapped_ids() if @p first_id_wins is true, and to the last one
+   * otherwise. This is what happens when
+   * VectorTools::interpolate_boundary_values is called once per id on
+   * an AffineConstraints object, or on a std::map, respectively.
+   *
+   * Return false, leaving @p boundary_dofs empty, if the finite element
+   * is not primitive, has no support points on the faces, or if the
+   * DoFHandler uses more than one finite element. The boundary values
+   * must then be interpolated one id at a time.
+   */
+  bool
+  collect_boundary_dofs(const dealii::Mapping<dim, spacedim> &   mapping,
+                        const dealii::DoFHandler<dim, spacedim> &dof_handler,
+                        const bool                               first_id_wins,
+                        BoundaryDoFs &boundary_dofs) const;
+
+  /**
+   * Compute the L2 projection of the mapped function of each mapped id on
+   * its boundary faces, restricted to the components selected by its
+   * mask, and store in the i-th entry of @p boundary_values the values of
+   * the locally relevant boundary dofs of the i-th mapped id. Each id is
+   * projected independently, so that a dof shared by several ids has a
+   * value for each of them.
+   *
+   * Return false, without computing anything, if the finite element is
+   * not primitive, if the DoFHandler uses more than one finite element,
+   * for dim == 1, or if there are hanging nodes on the boundary.
+   */
+  bool
+  project_all_boundary_values(
+    const dealii::Mapping<dim, spacedim> &   mapping,
+    const dealii::DoFHandler<dim, spacedim> &dof_handler,
+    const dealii::Quadrature<dim - 1> &      quadrature,
+    std::vector<std::map<dealii::types::global_dof_index, double>>
+      &boundary_values) const;
+
+  /**
+   * Evaluate the mapped function of the @p b-th id of @p boundary_dofs at
+   * its support points. The values are ordered as the degrees of freedom.
+   */
+  std::vector<double>
+  evaluate_boundary_values(const BoundaryDoFs &boundary_dofs,
+                           const unsigned int  b) const;
+
   /**
    * Number of components of the underlying Function objects.
    */
   const unsigned int n_components;
+
+  /**
+   * A constraint which depends on the boundary dofs: the dof it
+   * constrains, its inhomogeneity before close(), and its entries which
+   * refer to the boundary dofs or to other dependent constraints.
+   */
+  struct DependentLine
+  {
+    dealii::types::global_dof_index index;
+    double                          inhomogeneity;
+    std::vector<std::pair<dealii::types::global_dof_index, double>> entries;
+  };
+
+  /**
+   * The boundary dofs constrained by the last call of
+   * interpolate_boundary_values() on an AffineConstraints object, used by
+   * update_inhomogeneities().
+   */
+  mutable BoundaryDoFs constrained_dofs;
+
+  /**
+   * The inhomogeneities of constrained_dofs. Those of the ids which do
+   * not depend on the time are never evaluated again.
+   */
+  mutable std::vector<std::vector<double>> constrained_values;
+
+  /**
+   * The constraints which depended on constrained_dofs at that time,
+   * sorted such that every line comes after the lines it depends on.
+   */
+  mutable std::vector<DependentLine> dependent_lines;
+
+  /**
+   * Whether constrained_dofs refers to the last call of
+   * interpolate_boundary_values() on an AffineConstraints object.
+   */
+  mutable bool constrained_dofs_are_valid = false;
 };
 
 D2K_NAMESPACE_CLOSE
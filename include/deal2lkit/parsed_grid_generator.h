@@ -20,6 +20,7 @@
 
 #include <deal.II/base/parameter_handler.h>
 
+#include <deal.II/distributed/fully_distributed_tria.h>
 #include <deal.II/distributed/tria.h>
 
 #include <deal.II/grid/grid_generator.h>
@@ -79,6 +80,11 @@ struct PGGHelper;
  *   // indications in "file.prm'', in the section "3D mesh"
  *   std::unique_ptr<parallel::distributed::Triangulation<3,3>> tria_mpi =
  *         tria_builder_3d.distributed(MPI_COMM_WORLD);
+ *
+ *   // Or construct a parallel::fullydistributed::Triangulation, refined
+ *   // twice, in which every process only stores its own cells
+ *   auto tria_fully_distributed =
+ *         tria_builder_3d.fully_distributed(MPI_COMM_WORLD, 2);
  * \endcode
  *
  * Once the function ParameterAcceptor::initialize("file.prm",
@@ -199,11 +205,25 @@ public:
   declare_parameters(dealii::ParameterHandler &prm);
 
   /**
-   * Return a unique pointer to a newly created serial Triangulation. It will
-   * throw an exception if called before any parsing has occured.
+   * Return a unique pointer to a newly created serial Triangulation,
+   * refined globally @p n_refinements times. It will throw an exception
+   * if called before any parsing has occured.
+   *
+   * If a `Triangulation cache directory` is given, the refined
+   * Triangulation is saved there, and it is loaded from the cache
+   * instead of being regenerated the next time the same grid is
+   * requested with the same number of refinements. The contents of the
+   * grid file and of the CAD files used by the manifold descriptors are
+   * part of the key of the cache, so that editing them invalidates it.
+   *
+   * If several processes create the same serial Triangulation, they
+   * should pass their communicator as @p comm, and call this function
+   * together: the grid file is then hashed, and the cache is written,
+   * only by the first process of @p comm.
    */
   std::unique_ptr<dealii::Triangulation<dim, spacedim>>
-  serial();
+  serial(const unsigned int n_refinements = 0,
+         MPI_Comm           comm          = MPI_COMM_SELF);
 
   /**
    * Generate the grid. Fill a user supplied empty Triangulation using
@@ -353,10 +373,41 @@ public:
    * will throw an exception if called before any parsing has
    * occured. It is the user's responsability to destroy the created
    * grid once it is no longer needed.
+   *
+   * If the grid is read from a file in one of the formats supported by
+   * GridIn (vtk, msh, ucd, inp or unv), the file is read and parsed only
+   * on the first process of @p mpi_communicator, and the coarse mesh
+   * is then broadcast to the other processes.
+   *
+   * The Triangulation is refined globally @p n_refinements times. The
+   * `Triangulation cache directory` is not used here: loading a saved
+   * parallel::distributed::Triangulation refines the coarse mesh again,
+   * so it is not faster than refine_global().
    */
   std::unique_ptr<dealii::parallel::distributed::Triangulation<dim, spacedim>>
-  distributed(MPI_Comm mpi_communicator);
+  distributed(MPI_Comm           mpi_communicator,
+              const unsigned int n_refinements = 0);
 #  endif
+
+  /**
+   * Return a pointer to a newly created
+   * parallel::fullydistributed::Triangulation, in which every process
+   * only stores its own cells and a layer of ghost cells.
+   *
+   * The grid is created (and read from file, if requested) only on the
+   * first process of @p mpi_communicator, refined @p n_refinements times,
+   * and partitioned with METIS if available, or along a Z-order curve
+   * otherwise. Each process then receives only the description of its
+   * own part of the mesh.
+   *
+   * A parallel::fullydistributed::Triangulation cannot be refined
+   * further, so that all the global refinements should be requested
+   * through @p n_refinements.
+   */
+  std::unique_ptr<
+    dealii::parallel::fullydistributed::Triangulation<dim, spacedim>>
+  fully_distributed(MPI_Comm           mpi_communicator,
+                    const unsigned int n_refinements = 0);
 #endif
 
   /**
@@ -427,6 +478,47 @@ private:
   void
   parse_manifold_descriptors(const std::string &str_manifold_descriptors);
 
+  /**
+   * Set the manifold ids and attach the manifold descriptors to a
+   * Triangulation whose coarse mesh has already been created.
+   */
+  void
+  attach_manifolds(dealii::Triangulation<dim, spacedim> &tria);
+
+  /**
+   * Attach to a Triangulation whose manifold ids have already been set
+   * all the manifolds of the grid: both the ones attached by the
+   * GridGenerator function and the manifold descriptors.
+   */
+  void
+  set_manifolds(dealii::Triangulation<dim, spacedim> &tria);
+
+  /**
+   * Return the name of the file in the `Triangulation cache directory`
+   * where the current grid, refined @p n_refinements times, is stored.
+   * The name contains a hash of all the parameters that define the
+   * grid, and of the content of the input grid file, if any. The hash
+   * is computed on the first process of @p comm, and sent to the others.
+   * Return an empty string if no cache directory was given.
+   */
+  std::string
+  cache_file_name(const std::string &prefix,
+                  const unsigned int n_refinements,
+                  MPI_Comm           comm) const;
+
+#ifdef DEAL_II_WITH_MPI
+  /**
+   * If the grid is read from a file in one of the formats supported by
+   * GridIn, read it on the first process of @p comm only, broadcast
+   * its coarse mesh to the other processes and create @p tria from it
+   * on all processes. Otherwise, return false and leave @p tria
+   * untouched.
+   */
+  bool
+  create_from_file_on_root(dealii::Triangulation<dim, spacedim> &tria,
+                           MPI_Comm                              comm);
+#endif
+
   /**
    * Mesh smoothing to apply to the newly created Triangulation. This
    * variable is only used if the method serial() is called. For the
@@ -547,6 +639,19 @@ private:
    */
   std::string output_grid_file_name;
 
+  /**
+   * Directory where refined triangulations are cached. If empty, no
+   * cache is used.
+   */
+  std::string cache_directory;
+
+  /**
+   * Communicator of the Triangulation being created. CAD files are read
+   * on its first process only, and sent to the other ones. It is
+   * MPI_COMM_SELF unless a parallel Triangulation is being created.
+   */
+  MPI_Comm mpi_communicator;
+
   // strings for prm
   std::string str_point_1;
   std::string str_point_2;
@@ -27,6 +27,7 @@
 
 #include <algorithm>
 #include <map>
+#include <set>
 
 
 
@@ -40,6 +41,10 @@ D2K_NAMESPACE_OPEN
  * Dirichlet Boundary conditions, Neumann boundary conditions
  * and forcing terms can be easily handled with this class.
  *
+ * The functions are ParsedBatchFunction objects: calling value_list()
+ * or vector_value_list() on all the quadrature points of a cell is much
+ * faster than calling value() once per point.
+ *
  * A typical usage of this class is the following
  *
  *
@@ -154,6 +159,14 @@ public:
   bool
   acts_on_id(unsigned int &id) const;
 
+  /**
+   * return true if the expression associated to the given id depends on
+   * the time, i.e., if it uses the variable t. The expressions are
+   * analysed once, when the parameters are parsed.
+   */
+  bool
+  is_time_dependent(const unsigned int &id) const;
+
   /**
    * set time equal to t for all the mapped functions
    */
@@ -235,6 +248,7 @@ protected:
   std::vector<std::pair<unsigned int, std::string>>
                                       normal_components; // first component vector, variable_name+"N"
   std::map<unsigned int, std::string> id_str_functions;
+  std::set<unsigned int>              time_dependent_ids;
   std::map<std::pair<unsigned int, unsigned int>,
            shared_ptr<dealii::Functions::ParsedFunction<spacedim>>>
     _normal_functions;
@@ -28,6 +28,8 @@
 #  include <deal2lkit/parsed_finite_element.h>
 #  include <deal2lkit/utilities.h>
 
+#  include <Epetra_RowMatrix.h>
+
 
 
 D2K_NAMESPACE_OPEN
@@ -83,7 +85,53 @@ public:
 
   using dealii::TrilinosWrappers::PreconditionAMG::initialize;
 
+  /**
+   * Report the number of iterations of the last solve preconditioned by
+   * this object. With the "reuse until iteration growth" policy, the
+   * hierarchy is rebuilt from scratch at the next initialization when
+   * the number of iterations has grown by more than the `Maximum
+   * iteration growth` with respect to the first solve after the last
+   * rebuild. It is ignored by the other policies.
+   *
+   * A ParsedSolver calls this function after every solve when
+   * ParsedSolver::report_iterations_to() has been called with this
+   * object.
+   */
+  void
+  report_iterations(const unsigned int n_iterations);
+
+  /**
+   * Return true if the last call to initialize_preconditioner()
+   * recomputed the existing hierarchy for the new entries of the matrix,
+   * instead of building a new one.
+   */
+  bool
+  reused_hierarchy() const;
+
 private:
+  /**
+   * Return true if the hierarchy built for @p matrix can be reused: the
+   * matrix must be the same object, with the same size and number of
+   * nonzero entries, since ML keeps a pointer to it.
+   */
+  bool
+  can_reuse_hierarchy(const Epetra_RowMatrix &matrix) const;
+
+  /**
+   * Recompute the preconditioner for the new entries of the matrix,
+   * keeping the aggregates and the prolongators of the hierarchy.
+   */
+  void
+  recompute_hierarchy();
+
+  /**
+   * Build the whole hierarchy for @p matrix from scratch.
+   */
+  void
+  build_hierarchy(
+    const Epetra_RowMatrix &                                         matrix,
+    const dealii::TrilinosWrappers::PreconditionAMG::AdditionalData &data);
+
   /**
    * Determines whether the AMG preconditioner should be optimized for
    * elliptic problems (ML option smoothed aggregation SA, using a
@@ -129,6 +177,18 @@ private:
    */
   std::string var_const_modes;
 
+  /**
+   * Near null space used for a vector @p var_const_modes. With
+   * "constant modes", only the translations of each component are
+   * passed to the preconditioner. With "rigid body modes", also the
+   * rotations are added, computed from the support points of the
+   * degrees of freedom. This is the near null space of linear
+   * elasticity, and it improves considerably the convergence for
+   * elasticity-like problems. Scalar variables always use the
+   * constant mode.
+   */
+  std::string near_null_space;
+
   /**
    * Determines how many sweeps of the smoother should be
    * performed. When the flag elliptic is set to true, i.e., for
@@ -172,6 +232,53 @@ private:
    * settings as for the smoother type are possible.
    */
   std::string coarse_type;
+
+  /**
+   * Determines when the AMG hierarchy is rebuilt by
+   * initialize_preconditioner(). Possibilities are "rebuild always",
+   * "reuse aggregates" (the aggregates and prolongators are kept as
+   * long as the same matrix object is used, and only the coarse
+   * operators, the smoothers and the coarse solver are recomputed), and
+   * "reuse until iteration growth" (as "reuse aggregates", but the
+   * hierarchy is rebuilt when the number of iterations reported through
+   * report_iterations() grows too much).
+   */
+  std::string reuse_policy;
+
+  /**
+   * Maximum growth, in percent, of the number of iterations before the
+   * hierarchy is rebuilt, for the "reuse until iteration growth" policy.
+   */
+  double max_iteration_growth;
+
+  /**
+   * The matrix the current hierarchy was built for.
+   */
+  const Epetra_RowMatrix *hierarchy_matrix;
+
+  /**
+   * Global number of rows and of nonzero entries of hierarchy_matrix
+   * when the hierarchy was built. A matrix reinitialized with another
+   * sparsity pattern may end up at the same address.
+   */
+  long long hierarchy_n_rows;
+  long long hierarchy_n_nonzeros;
+
+  /**
+   * Number of iterations of the first solve after the last rebuild of
+   * the hierarchy. Zero if not yet known.
+   */
+  unsigned int reference_iterations;
+
+  /**
+   * Set by report_iterations() when the hierarchy should be rebuilt.
+   */
+  bool rebuild_requested;
+
+  /**
+   * Whether the last initialization reused the hierarchy.
+   */
+  bool last_initialization_reused;
 };
 
 
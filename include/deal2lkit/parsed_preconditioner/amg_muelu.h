@@ -28,6 +28,10 @@
 #  include <deal2lkit/parsed_finite_element.h>
 #  include <deal2lkit/utilities.h>
 
+#  include <Epetra_CrsMatrix.h>
+
+#  include <vector>
+
 
 
 D2K_NAMESPACE_OPEN
@@ -84,7 +88,52 @@ public:
 
   using dealii::TrilinosWrappers::PreconditionAMGMueLu::initialize;
 
+  /**
+   * Return true if the last call to initialize_preconditioner() set up
+   * the existing hierarchy again, according to the `Reuse type`,
+   * instead of building a new one.
+   */
+  bool
+  reused_hierarchy() const;
+
+  /**
+   * Return, for each level of the hierarchy, the number of processes
+   * owning at least one row of the matrix of that level. With
+   * repartitioning, the coarse levels are gathered on fewer processes.
+   * This function must be called on all the processes of the
+   * communicator of the matrix, which must still exist.
+   */
+  std::vector<unsigned int>
+  n_processes_per_level() const;
+
 private:
+  /**
+   * Fill the ML options of @p data that do not depend on the near null
+   * space.
+   */
+  void
+  set_ml_options(
+    dealii::TrilinosWrappers::PreconditionAMG::AdditionalData &data) const;
+
+  /**
+   * Try to set up the current hierarchy again for the new entries of
+   * @p matrix, according to the reuse type. Return false if the
+   * hierarchy must be built from scratch.
+   */
+  bool
+  reuse_hierarchy(const Epetra_CrsMatrix &matrix);
+
+  /**
+   * Build the hierarchy for @p matrix from scratch. The options in
+   * @p data, including the near null space, are translated by MueLu into
+   * its own parameters, and the repartitioning and reuse options are
+   * added to them.
+   */
+  void
+  build_hierarchy(
+    const Epetra_CrsMatrix &                                         matrix,
+    const dealii::TrilinosWrappers::PreconditionAMG::AdditionalData &data);
+
   /**
    * Determines whether the AMG preconditioner should be optimized for
    * elliptic problems (ML option smoothed aggregation SA, using a
@@ -124,6 +173,18 @@ private:
    */
   std::string var_const_modes;
 
+  /**
+   * Near null space used for a vector @p var_const_modes. With
+   * "constant modes", only the translations of each component are
+   * passed to the preconditioner. With "rigid body modes", also the
+   * rotations are added, computed from the support points of the
+   * degrees of freedom. This is the near null space of linear
+   * elasticity, and it improves considerably the convergence for
+   * elasticity-like problems. Scalar variables always use the
+   * constant mode.
+   */
+  std::string near_null_space;
+
   /**
    * Determines how many sweeps of the smoother should be
    * performed. When the flag elliptic is set to true, i.e., for
@@ -167,6 +228,57 @@ private:
    * settings as for the smoother type are possible.
    */
   std::string coarse_type;
+
+  /**
+   * Rebalance the coarse levels across the processes, so that each
+   * process owns either no rows or at least @p repartition_min_rows rows.
+   */
+  bool repartition;
+
+  /**
+   * Minimum number of rows per process on the coarse levels, below
+   * which the level is repartitioned on fewer processes.
+   */
+  unsigned int repartition_min_rows;
+
+  /**
+   * Maximum ratio between the largest and the average number of rows
+   * per process on a coarse level, above which the level is
+   * repartitioned.
+   */
+  double repartition_max_imbalance;
+
+  /**
+   * First level on which repartitioning is considered.
+   */
+  unsigned int repartition_start_level;
+
+  /**
+   * Which parts of the hierarchy are kept when the preconditioner is
+   * initialized again with the same matrix object: "none" (the
+   * hierarchy is rebuilt), "tP" (the tentative prolongators), "RP" (the
+   * smoothed prolongators and restrictors) or "full" (the whole
+   * hierarchy, including the smoothers, is left untouched).
+   */
+  std::string reuse_type;
+
+  /**
+   * The matrix the current hierarchy was built for.
+   */
+  const Epetra_CrsMatrix *hierarchy_matrix;
+
+  /**
+   * Global number of rows and of nonzero entries of hierarchy_matrix
+   * when the hierarchy was built. A matrix reinitialized with another
+   * sparsity pattern may end up at the same address.
+   */
+  long long hierarchy_n_rows;
+  long long hierarchy_n_nonzeros;
+
+  /**
+   * Whether the last initialization reused the hierarchy.
+   */
+  bool last_initialization_reused;
 };
 
 
@@ -0,0 +1,233 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+#ifndef d2k_parsed_gmg_preconditioner_h
+#define d2k_parsed_gmg_preconditioner_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/mg_level_object.h>
+#include <deal.II/base/quadrature.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/mapping.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+
+#include <deal.II/matrix_free/operators.h>
+
+#include <deal.II/multigrid/mg_base.h>
+#include <deal.II/multigrid/mg_constrained_dofs.h>
+#include <deal.II/multigrid/mg_smoother.h>
+#include <deal.II/multigrid/mg_transfer_matrix_free.h>
+#include <deal.II/multigrid/multigrid.h>
+
+#include <deal2lkit/config.h>
+#include <deal2lkit/parameter_acceptor.h>
+#include <deal2lkit/utilities.h>
+
+#include <memory>
+#include <set>
+
+
+
+D2K_NAMESPACE_OPEN
+
+/**
+ * A parsed matrix-free geometric multigrid preconditioner, which uses
+ * parameter files to choose between different options.
+ *
+ * The operator on each level is a dealii::MatrixFreeOperators::
+ * LaplaceOperator, built on its own dealii::MatrixFree object, so that
+ * no matrix is ever assembled. This makes it suitable for high order
+ * FE_Q elements, for which the memory and the time needed to assemble
+ * a sparse matrix dominate. The levels are connected by a
+ * dealii::MGTransferMatrixFree, and smoothed by Chebyshev iterations
+ * preconditioned by the inverse of the diagonal of the level operator.
+ *
+ * The DoFHandler must be scalar and must have the level degrees of
+ * freedom distributed, i.e., dof_handler.distribute_mg_dofs() must have
+ * been called. The vectors are dealii::LinearAlgebra::distributed::Vector
+ * objects, as required by the matrix-free framework.
+ *
+ * This object can be used as the preconditioner of a ParsedSolver:
+ *
+ * @code
+ * ParsedGMGPreconditioner<dim> gmg;
+ * ParsedSolver<VEC> Ainv("Solver", "cg", 1000, 1e-10,
+ *                        linear_operator<VEC>(A),
+ *                        linear_operator<VEC>(A, gmg));
+ * ParameterAcceptor::initialize(...);
+ *
+ * gmg.initialize_preconditioner(dof_handler, mapping, dirichlet_ids);
+ * x = Ainv * b;
+ * @endcode
+ */
+template <int dim,
+          typename VECTOR = dealii::LinearAlgebra::distributed::Vector<double>>
+class ParsedGMGPreconditioner : public ParameterAcceptor
+{
+public:
+  /**
+   * The operator used on each level.
+   */
+  using LevelMatrix = dealii::MatrixFreeOperators::
+    LaplaceOperator<dim, -1, 0, 1, VECTOR>;
+
+  /**
+   * Constructor.
+   */
+  ParsedGMGPreconditioner(const std::string & name = "GMG Preconditioner",
+                          const unsigned int &smoother_degree  = 5,
+                          const double &      smoothing_range  = 20.,
+                          const unsigned int &n_levels         = 0,
+                          const std::string & coarse_solver    = "chebyshev",
+                          const double &      coarse_reduction = 1e-3);
+
+  /**
+   * Declare preconditioner options.
+   */
+  virtual void
+  declare_parameters(dealii::ParameterHandler &prm);
+
+  /**
+   * Build the level operators, the transfer and the smoothers for the
+   * given DoFHandler, with homogeneous Dirichlet conditions on the
+   * @p dirichlet_ids. The level operators are integrated with a Gauss
+   * formula with @p n_q_points_1d points per direction, or with the
+   * degree of the finite element plus one points if zero.
+   */
+  void
+  initialize_preconditioner(
+    const dealii::DoFHandler<dim> &             dof_handler,
+    const dealii::Mapping<dim> &                mapping,
+    const std::set<dealii::types::boundary_id> &dirichlet_ids =
+      std::set<dealii::types::boundary_id>(),
+    const unsigned int n_q_points_1d = 0);
+
+  /**
+   * Apply one multigrid cycle.
+   */
+  void
+  vmult(VECTOR &dst, const VECTOR &src) const;
+
+  /**
+   * Apply one multigrid cycle. The Laplace operator is symmetric, and
+   * so is the preconditioner.
+   */
+  void
+  Tvmult(VECTOR &dst, const VECTOR &src) const;
+
+  /**
+   * Return the operator of the given @p level.
+   */
+  const LevelMatrix &
+  get_level_matrix(const unsigned int level) const;
+
+private:
+  using Smoother = dealii::PreconditionChebyshev<LevelMatrix, VECTOR>;
+
+  using Transfer = dealii::MGTransferMatrixFree<dim, double>;
+
+  /**
+   * Degree of the Chebyshev smoother, i.e., the number of
+   * matrix-vector products performed on each level.
+   */
+  unsigned int smoother_degree;
+
+  /**
+   * Ratio between the largest eigenvalue of each level operator and the
+   * smallest one damped by the Chebyshev smoother.
+   */
+  double smoothing_range;
+
+  /**
+   * Number of levels used by the multigrid cycle, counting from the
+   * finest one. If zero, all the levels of the triangulation are used.
+   */
+  unsigned int n_levels;
+
+  /**
+   * Solver used on the coarsest level: "chebyshev" applies a Chebyshev
+   * iteration with enough steps to act as a solver, "cg" runs conjugate
+   * gradients up to the coarse reduction.
+   */
+  std::string coarse_solver;
+
+  /**
+   * Reduction of the residual required to the "cg" coarse solver.
+   */
+  double coarse_reduction;
+
+  /**
+   * Constraints on the level degrees of freedom.
+   */
+  dealii::MGConstrainedDoFs mg_constrained_dofs;
+
+  /**
+   * The operators on the levels used by the multigrid cycle.
+   */
+  dealii::MGLevelObject<LevelMatrix> mg_matrices;
+
+  /**
+   * The transfer between the levels.
+   */
+  std::unique_ptr<Transfer> mg_transfer;
+
+  /**
+   * The Chebyshev smoothers.
+   */
+  dealii::mg::SmootherRelaxation<Smoother, VECTOR> mg_smoother;
+
+  /**
+   * Wrapper of the level operators used by the multigrid cycle.
+   */
+  dealii::mg::Matrix<VECTOR> mg_matrix;
+
+  /**
+   * The coarse solver.
+   */
+  std::unique_ptr<dealii::MGCoarseGridBase<VECTOR>> mg_coarse;
+
+  /**
+   * Control of the "cg" coarse solver.
+   */
+  std::unique_ptr<dealii::ReductionControl> coarse_control;
+
+  /**
+   * The "cg" coarse solver.
+   */
+  std::unique_ptr<dealii::SolverCG<VECTOR>> coarse_cg;
+
+  /**
+   * The multigrid cycle.
+   */
+  std::unique_ptr<dealii::Multigrid<VECTOR>> mg;
+
+  /**
+   * The multigrid cycle, wrapped as a preconditioner on the active
+   * degrees of freedom.
+   */
+  std::unique_ptr<dealii::PreconditionMG<dim, VECTOR, Transfer>>
+    preconditioner;
+};
+
+D2K_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,58 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+#ifndef d2k_rigid_body_modes_h
+#define d2k_rigid_body_modes_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/component_mask.h>
+#include <deal.II/fe/mapping_q1.h>
+
+#include <deal2lkit/config.h>
+
+#include <vector>
+
+
+D2K_NAMESPACE_OPEN
+
+/**
+ * Compute the rigid body modes of the vector variable selected by
+ * @p component_mask, i.e., the spacedim translations and the rotations
+ * (one in 2d, three in 3d) of the displacement field. They are the near
+ * null space of elasticity-like operators, and they are used by the
+ * algebraic multigrid preconditioners to build the coarse spaces.
+ *
+ * The rotations are evaluated at the support points of the degrees of
+ * freedom, as given by @p mapping, so the finite element must have
+ * support points. The mask must select exactly spacedim components.
+ *
+ * The result has the same layout of the constant modes returned by
+ * dealii::DoFTools::extract_constant_modes(): one vector per mode, with
+ * one entry per locally owned degree of freedom, and a zero entry for
+ * the degrees of freedom that do not belong to the selected variable.
+ */
+template <int dim, int spacedim>
+std::vector<std::vector<double>>
+extract_rigid_body_modes(const dealii::DoFHandler<dim, spacedim> &dh,
+                         const dealii::ComponentMask &component_mask,
+                         const dealii::Mapping<dim, spacedim> &mapping =
+                           dealii::StaticMappingQ1<dim, spacedim>::mapping);
+
+D2K_NAMESPACE_CLOSE
+
+#endif
@@ -18,6 +18,13 @@
 
 #include <deal.II/base/config.h>
 
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/lac/block_vector.h>
+#include <deal.II/lac/la_parallel_block_vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
 #include <deal.II/lac/linear_operator.h>
 #include <deal.II/lac/solver.h>
 #include <deal.II/lac/solver_bicgstab.h>
@@ -27,11 +34,23 @@
 #include <deal.II/lac/solver_minres.h>
 #include <deal.II/lac/solver_qmrs.h>
 #include <deal.II/lac/solver_richardson.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/vector_memory.h>
 
 #include <deal2lkit/config.h>
 #include <deal2lkit/parameter_acceptor.h>
+#include <deal2lkit/solver_deflated_cg.h>
+#include <deal2lkit/solver_pipelined_cg.h>
+#include <deal2lkit/solver_s_step_gmres.h>
 #include <deal2lkit/utilities.h>
 
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+
 
 
 D2K_NAMESPACE_OPEN
@@ -49,6 +68,78 @@ default_reinit()
   };
 }
 
+namespace internal
+{
+  /**
+   * The communicator of @p v, for the vector types which have one.
+   */
+  template <typename VECTOR>
+  auto
+  vector_communicator(const VECTOR &v, int)
+    -> decltype(v.get_mpi_communicator(), MPI_Comm())
+  {
+    return v.get_mpi_communicator();
+  }
+
+  /**
+   * The communicator of the first block of @p v, for the block vectors
+   * without get_mpi_communicator().
+   */
+  template <typename VECTOR>
+  auto
+  vector_communicator(const VECTOR &v, long)
+    -> decltype(v.block(0).get_mpi_communicator(), MPI_Comm())
+  {
+    return v.block(0).get_mpi_communicator();
+  }
+
+  /**
+   * Serial vector types.
+   */
+  template <typename VECTOR>
+  MPI_Comm
+  vector_communicator(const VECTOR &, ...)
+  {
+    return MPI_COMM_SELF;
+  }
+} // namespace internal
+
+/**
+ * The single precision counterpart of a vector type, used by the mixed
+ * precision mode of ParsedSolver. Vector types without a single
+ * precision version, like the Trilinos and PETSc ones, are their own
+ * counterpart.
+ */
+template <typename VECTOR>
+struct SinglePrecision
+{
+  using type = VECTOR;
+};
+
+template <>
+struct SinglePrecision<dealii::Vector<double>>
+{
+  using type = dealii::Vector<float>;
+};
+
+template <>
+struct SinglePrecision<dealii::BlockVector<double>>
+{
+  using type = dealii::BlockVector<float>;
+};
+
+template <>
+struct SinglePrecision<dealii::LinearAlgebra::distributed::Vector<double>>
+{
+  using type = dealii::LinearAlgebra::distributed::Vector<float>;
+};
+
+template <>
+struct SinglePrecision<dealii::LinearAlgebra::distributed::BlockVector<double>>
+{
+  using type = dealii::LinearAlgebra::distributed::BlockVector<float>;
+};
+
 /**
  * A solver selector which uses parameter files to choose between
  * different options. This object is a LinearOperator which can be
@@ -66,12 +157,91 @@ default_reinit()
  * x = Ainv*b;
  *
  * @endcode
+ *
+ * In time dependent problems, the solution of the previous step is
+ * usually a good initial guess for the next one. The parameter
+ * "Initial guess" selects whether the solver starts from zero, from
+ * the last solution, or from a linear or quadratic extrapolation of
+ * the last two or three solutions (assuming equally spaced steps).
+ * The solutions are recorded after every successful solve, and the
+ * history can be discarded with clear_history(), e.g., after the mesh
+ * has changed. The initial guess is used both by vmult() and by
+ * solve().
+ *
+ * For sequences of slowly varying symmetric positive definite systems,
+ * the "deflated-cg" solver keeps a subspace of approximate eigenvectors
+ * of op between successive solves (see SolverDeflatedCG), so that the
+ * slowest modes are not rediscovered at every solve. Its dimension is
+ * set by "Recycled subspace dimension". The subspace is discarded when
+ * the size of the problem changes, by set_operator() and by
+ * clear_history(). Its products with op are recomputed at every solve,
+ * unless "Recycled operator is constant" is true. In that case, op must
+ * be replaced through set_operator(), since the products with an op
+ * assigned directly would not be recomputed. Otherwise, assigning op
+ * directly keeps the subspace, which is only discarded if its Rayleigh
+ * quotients show that the new operator is very different.
+ *
+ * When "Mixed precision" is true, the system is solved by iterative
+ * refinement: the residual is computed in double precision with op,
+ * and the correction is computed by the selected solver on the single
+ * precision operators op_single and prec_single, up to the "Inner
+ * reduction". The outer loop stops when the Reduction and Tolerance of
+ * the solver are reached in double precision. By default, op_single
+ * and prec_single convert their arguments and apply op and prec, which
+ * gives the right result but no speedup: assign them operators built
+ * on single precision copies of the matrix and of the preconditioner,
+ * e.g.,
+ *
+ * @code
+ * SparseMatrix<float> A_float;
+ * A_float.copy_from(A);
+ * PreconditionSSOR<SparseMatrix<float>> ssor;
+ * ssor.initialize(A_float);
+ *
+ * Ainv.op_single   = linear_operator<Vector<float>>(A_float);
+ * Ainv.prec_single = linear_operator<Vector<float>>(A_float, ssor);
+ * @endcode
+ *
+ * On large parallel runs, the latency of the global reductions of the
+ * scalar products can dominate the cost of the iterations. The
+ * "pipelined-cg" solver (see SolverPipelinedCG) performs a single
+ * reduction per iteration, overlapped with the application of the
+ * preconditioner and of the operator. The "s-step gmres" solver (see
+ * SolverSStepGMRES) restarts every "S-step size" iterations, and
+ * waits for two reductions per restart.
+ *
+ * With the "auto" solver, the solver is chosen at run time among the
+ * "Auto candidates", optionally combined with the preconditioners
+ * registered with add_preconditioner_candidate() and listed in "Auto
+ * preconditioners". During the first "Auto tuning solves" solves, every
+ * candidate solves the same system from the same initial guess, so that
+ * their wall times are comparable, and the solution of the fastest one
+ * is returned. The candidate with the smallest total wall time, taken
+ * as the maximum over the processes of the communicator of the vectors
+ * (see set_tuning_communicator()), is used from then on. A candidate
+ * which does not converge is discarded. If "Auto tuning file"
+ * is not empty, the decision is written to it, and it is read back
+ * instead of tuning again when the file already exists:
+ *
+ * @code
+ * ParsedSolver<VEC> Ainv("Solver", "auto");
+ * ParameterAcceptor::initialize(...);
+ *
+ * Ainv.op = linear_operator<VEC>(A);
+ * Ainv.add_preconditioner_candidate("amg", linear_operator<VEC>(A, amg));
+ * Ainv.add_preconditioner_candidate("ilu", linear_operator<VEC>(A, ilu));
+ * @endcode
  */
 template <typename VECTOR>
 class ParsedSolver : public dealii::LinearOperator<VECTOR, VECTOR>,
                      public ParameterAcceptor
 {
 public:
+  /**
+   * Single precision vector type used in the mixed precision mode.
+   */
+  using SingleVector = typename SinglePrecision<VECTOR>::type;
+
   /**
    * Constructor. Build the inverse of an Operator using a parameter
    * file. A section name can be specified, the solver type, the
@@ -110,8 +280,8 @@ public:
 
   /**
    * The Operator this solver use. You can assign a new one at
-   * construction time, or by this->op = some_new_op. By default it is
-   * the identity operator.
+   * construction time, by this->op = some_new_op, or by set_operator().
+   * By default it is the identity operator.
    */
   dealii::LinearOperator<VECTOR> op;
 
@@ -123,18 +293,195 @@ public:
   dealii::LinearOperator<VECTOR> prec;
 
   /**
-   * ReductionControl. Used internally by the solver.
+   * Single precision version of op, used in the mixed precision mode.
+   */
+  dealii::LinearOperator<SingleVector> op_single;
+
+  /**
+   * Single precision version of prec, used in the mixed precision mode.
+   */
+  dealii::LinearOperator<SingleVector> prec_single;
+
+  /**
+   * ReductionControl. Used internally by the solver, and by the outer
+   * iterations of the mixed precision mode.
    */
   dealii::ReductionControl control;
 
+  /**
+   * ReductionControl of the single precision solver of the mixed
+   * precision mode.
+   */
+  dealii::ReductionControl inner_control;
+
+  /**
+   * Solve op*dst = src. If the "Initial guess" is "zero", the content
+   * of @p dst is used as initial guess, otherwise it is overwritten by
+   * the guess computed from the previous solutions.
+   */
+  void
+  solve(VECTOR &dst, const VECTOR &src);
+
+  /**
+   * Forget the previous solutions, and the recycled subspace of the
+   * "deflated-cg" solver.
+   */
+  void
+  clear_history();
+
+  /**
+   * Replace op with @p new_op, and discard the recycled subspace of the
+   * "deflated-cg" solver, which was built for the old operator. The
+   * previous solutions are kept as initial guesses.
+   */
+  void
+  set_operator(const dealii::LinearOperator<VECTOR> &new_op);
+
+  /**
+   * Register a preconditioner which the "auto" solver can choose, if
+   * its @p name is listed in "Auto preconditioners". When this is used,
+   * the auto solver overwrites prec with the chosen preconditioner.
+   */
+  void
+  add_preconditioner_candidate(const std::string &                   name,
+                               const dealii::LinearOperator<VECTOR> &prec);
+
+  /**
+   * Set the processes which take part in the solves, used by the "auto"
+   * solver to make the same choice on all of them. Only the first
+   * process writes the "Auto tuning file". By default, this is the
+   * communicator of the vectors, or MPI_COMM_SELF for the serial vector
+   * types: set it when the same choice must be made by processes which
+   * solve independent serial systems.
+   */
+  void
+  set_tuning_communicator(const MPI_Comm &comm);
+
+  /**
+   * Pass the number of iterations of every successful solve to
+   * @p preconditioner.report_iterations(), as needed by the "reuse until
+   * iteration growth" policy of ParsedAMGPreconditioner. The
+   * preconditioner must live longer than this object. The solves of the
+   * tuning phase of the "auto" solver, which try different
+   * preconditioners, are not reported.
+   */
+  template <typename PRECONDITIONER>
+  void
+  report_iterations_to(PRECONDITIONER &preconditioner);
+
 private:
   /**
-   * Store a shared pointer, and intilize the inverse operator.
+   * A solver and preconditioner pair tried by the "auto" solver.
+   */
+  struct Candidate
+  {
+    std::string  solver;
+    std::string  preconditioner;
+    unsigned int n_solves   = 0;
+    unsigned int iterations = 0;
+    double       time       = 0;
+    bool         failed     = false;
+  };
+
+  /**
+   * The names of the available solvers, separated by "|".
+   */
+  static std::string
+  solver_names();
+
+  /**
+   * Initialize the solver with the given name.
+   */
+  void
+  initialize_solver_by_name(const std::string &name);
+
+  /**
+   * Initialize the solver and the preconditioner of a candidate.
+   */
+  void
+  select_candidate(const unsigned int i);
+
+  /**
+   * Solve with the chosen candidate, or with all the candidates still
+   * being timed.
+   */
+  void
+  auto_solve(VECTOR &dst, const VECTOR &src);
+
+  /**
+   * Choose the fastest candidate, and let the first process of @p comm
+   * write the decision to the "Auto tuning file".
+   */
+  void
+  choose_candidate(const MPI_Comm &comm);
+
+  /**
+   * Read the decision from the "Auto tuning file". Return false if the
+   * file does not exist, or does not name one of the candidates.
+   */
+  bool
+  read_tuning_file();
+
+  /**
+   * Store a shared pointer, and initialize the inverse operator.
    */
   template <typename MySolver>
   void
   initialize_solver(MySolver *);
 
+  /**
+   * Store a shared pointer to a single precision solver, and initialize
+   * the inverse operator with iterative refinement.
+   */
+  template <typename MySolver>
+  void
+  initialize_mixed_precision_solver(MySolver *);
+
+  /**
+   * Build the solver of type MySolver, in double or single precision.
+   * The @p args are passed to its constructor after the SolverControl.
+   */
+  template <template <typename> class MySolver, typename... Args>
+  void
+  create_solver(const Args &... args);
+
+  /**
+   * Set the functions of the LinearOperator.
+   */
+  void
+  initialize_inverse();
+
+  /**
+   * Solve A x = b by iterative refinement, where the correction is
+   * computed by @p inner_solve in single precision.
+   */
+  void
+  refine(const dealii::LinearOperator<VECTOR> &                     A,
+         VECTOR &                                                   x,
+         const VECTOR &                                             b,
+         const std::function<void(SingleVector &, const SingleVector &)>
+           &inner_solve);
+
+  /**
+   * A single precision operator which converts its arguments and calls
+   * @p double_op. The vectors are initialized as the ones of op.
+   */
+  dealii::LinearOperator<SingleVector>
+  single_precision_operator(const dealii::LinearOperator<VECTOR> &double_op);
+
+  /**
+   * Compute the initial guess from the previous solutions. Return
+   * false if there are no usable previous solutions.
+   */
+  bool
+  compute_initial_guess(VECTOR &dst) const;
+
+  /**
+   * Record a new solution.
+   */
+  void
+  store_solution(const VECTOR &solution);
+
   /**
    * Solver name."
    */
@@ -152,10 +499,128 @@ private:
    */
   double reduction;
 
+  /**
+   * How the initial guess is computed: "zero", "last solution",
+   * "linear extrapolation" or "quadratic extrapolation".
+   */
+  std::string initial_guess;
+
+  /**
+   * Maximum dimension of the subspace recycled by "deflated-cg".
+   */
+  unsigned int recycled_dimension;
+
+  /**
+   * Whether op is the same for all the solves of "deflated-cg", so that
+   * the products of op with the recycled subspace can be reused.
+   */
+  bool recycled_constant_operator;
+
+  /**
+   * Number of iterations between two restarts of "s-step gmres".
+   */
+  unsigned int s_step_size;
+
+  /**
+   * Solvers tried by the "auto" solver.
+   */
+  std::vector<std::string> auto_solvers;
+
+  /**
+   * Preconditioners tried by the "auto" solver.
+   */
+  std::vector<std::string> auto_preconditioners;
+
+  /**
+   * Number of timed solves of every candidate of the "auto" solver.
+   */
+  unsigned int auto_tuning_solves;
+
+  /**
+   * File storing the decision of the "auto" solver.
+   */
+  std::string auto_tuning_file;
+
+  /**
+   * Candidates of the "auto" solver.
+   */
+  std::vector<Candidate> candidates;
+
+  /**
+   * The preconditioners registered by add_preconditioner_candidate().
+   */
+  std::map<std::string, dealii::LinearOperator<VECTOR>>
+    preconditioner_candidates;
+
+  /**
+   * The candidate chosen by the "auto" solver, or
+   * numbers::invalid_unsigned_int while tuning.
+   */
+  unsigned int chosen_candidate;
+
+  /**
+   * The candidate the solver and the preconditioner were last
+   * initialized for, or numbers::invalid_unsigned_int.
+   */
+  unsigned int active_candidate;
+
+  /**
+   * Communicator set by set_tuning_communicator().
+   */
+  MPI_Comm tuning_communicator;
+
+  /**
+   * Whether set_tuning_communicator() was called.
+   */
+  bool has_tuning_communicator;
+
+  /**
+   * Solve by iterative refinement with a single precision solver.
+   */
+  bool mixed_precision;
+
+  /**
+   * Reduction of the single precision solver in the mixed precision
+   * mode.
+   */
+  double inner_reduction;
+
+  /**
+   * The last solutions, the most recent one last.
+   */
+  std::deque<VECTOR> history;
+
   /**
    * The actual solver.
    */
   std::unique_ptr<dealii::Solver<VECTOR>> solver;
+
+  /**
+   * The actual solver, in the mixed precision mode.
+   */
+  std::unique_ptr<dealii::Solver<SingleVector>> single_solver;
+
+  /**
+   * Run the actual solver on op, starting from the content of the first
+   * argument.
+   */
+  std::function<void(VECTOR &, const VECTOR &)> run_solver;
+
+  /**
+   * Run the actual solver on the transpose of op, starting from zero.
+   */
+  std::function<void(VECTOR &, const VECTOR &)> run_transpose_solver;
+
+  /**
+   * Discard the recycled subspace of the actual solver, if any.
+   */
+  std::function<void()> clear_recycled_subspace;
+
+  /**
+   * Receive the number of iterations of every solve, if set by
+   * report_iterations_to().
+   */
+  std::function<void(const unsigned int)> iterations_reporter;
 };
 
 // ============================================================
@@ -175,7 +640,31 @@ ParsedSolver<VECTOR>::ParsedSolver(const std::string &name,
   , solver_name(default_solver)
   , max_iterations(default_iter)
   , reduction(default_reduction)
-{}
+  , initial_guess("zero")
+  , recycled_dimension(8)
+  , recycled_constant_operator(false)
+  , s_step_size(5)
+  , auto_solvers({"cg", "bicgstab", "gmres"})
+  , auto_tuning_solves(1)
+  , chosen_candidate(dealii::numbers::invalid_unsigned_int)
+  , active_candidate(dealii::numbers::invalid_unsigned_int)
+  , tuning_communicator(MPI_COMM_SELF)
+  , has_tuning_communicator(false)
+  , mixed_precision(false)
+  , inner_reduction(1e-4)
+{
+  op_single   = single_precision_operator(this->op);
+  prec_single = single_precision_operator(this->prec);
+}
+
+
+template <typename VECTOR>
+std::string
+ParsedSolver<VECTOR>::solver_names()
+{
+  return "cg|deflated-cg|pipelined-cg|bicgstab|gmres|fgmres|"
+         "s-step gmres|minres|qmrs|richardson";
+}
 
 
 template <typename VECTOR>
@@ -186,9 +675,94 @@ ParsedSolver<VECTOR>::declare_parameters(dealii::ParameterHandler &prm)
                 &solver_name,
                 "Solver name",
                 solver_name,
-                dealii::Patterns::Selection("cg|bicgstab|gmres|fgmres|"
-                                            "minres|qmrs|richardson"),
-                "Name of the solver to use.");
+                dealii::Patterns::Selection(solver_names() + "|auto"),
+                "Name of the solver to use. The auto solver chooses the\n"
+                "fastest of the Auto candidates at run time.");
+
+  add_parameter(prm,
+                &auto_solvers,
+                "Auto candidates",
+                print(auto_solvers, ", "),
+                dealii::Patterns::List(
+                  dealii::Patterns::Selection(solver_names()), 1),
+                "Solvers tried by the auto solver.");
+
+  add_parameter(prm,
+                &auto_preconditioners,
+                "Auto preconditioners",
+                "",
+                dealii::Patterns::List(dealii::Patterns::Anything()),
+                "Preconditioners tried by the auto solver, among the ones\n"
+                "registered with add_preconditioner_candidate(). If empty,\n"
+                "prec is used.");
+
+  add_parameter(prm,
+                &auto_tuning_solves,
+                "Auto tuning solves",
+                std::to_string(auto_tuning_solves),
+                dealii::Patterns::Integer(1),
+                "Number of timed solves of every candidate of the auto\n"
+                "solver.");
+
+  add_parameter(prm,
+                &auto_tuning_file,
+                "Auto tuning file",
+                "",
+                dealii::Patterns::Anything(),
+                "File storing the choice of the auto solver. If it exists,\n"
+                "the choice is read from it instead of tuning again.");
+
+  add_parameter(prm,
+                &initial_guess,
+                "Initial guess",
+                initial_guess,
+                dealii::Patterns::Selection(
+                  "zero|last solution|"
+                  "linear extrapolation|quadratic extrapolation"),
+                "Initial guess of the solver: zero, the last solution, or\n"
+                "a linear or quadratic extrapolation of the last two or three\n"
+                "solutions.");
+
+  add_parameter(prm,
+                &recycled_dimension,
+                "Recycled subspace dimension",
+                std::to_string(recycled_dimension),
+                dealii::Patterns::Integer(1),
+                "Number of approximate eigenvectors kept between successive\n"
+                "solves by the deflated-cg solver.");
+
+  add_parameter(prm,
+                &recycled_constant_operator,
+                "Recycled operator is constant",
+                "false",
+                dealii::Patterns::Bool(),
+                "Reuse the products of the operator with the recycled\n"
+                "subspace of the deflated-cg solver from the previous solve.\n"
+                "Set it only if the operator does not change between solves.");
+
+  add_parameter(prm,
+                &s_step_size,
+                "S-step size",
+                std::to_string(s_step_size),
+                dealii::Patterns::Integer(1),
+                "Number of iterations between two restarts of the s-step\n"
+                "gmres solver. Values larger than ten are not stable.");
+
+  add_parameter(prm,
+                &mixed_precision,
+                "Mixed precision",
+                "false",
+                dealii::Patterns::Bool(),
+                "Solve by iterative refinement in double precision, with the\n"
+                "selected solver running on op_single and prec_single.");
+
+  add_parameter(prm,
+                &inner_reduction,
+                "Inner reduction",
+                std::to_string(inner_reduction),
+                dealii::Patterns::Double(0.0),
+                "Reduction of the single precision solver, in the mixed\n"
+                "precision mode.");
 
   dealii::ReductionControl::declare_parameters(prm);
 
@@ -212,41 +786,600 @@ void
 ParsedSolver<VECTOR>::initialize_solver(MySolver *s)
 {
   solver.reset(s);
-  (dealii::LinearOperator<VECTOR, VECTOR> &)(*this) =
-    dealii::inverse_operator(op, *s, prec);
+  single_solver.reset();
+
+  // op and prec are read at every application, so that they can be
+  // assigned after the parameters have been parsed.
+  run_solver = [this, s](VECTOR &dst, const VECTOR &src) {
+    s->solve(op, dst, src, prec);
+  };
+
+  run_transpose_solver = [this, s](VECTOR &dst, const VECTOR &src) {
+    op.reinit_domain_vector(dst, false);
+    s->solve(dealii::transpose_operator(op),
+             dst,
+             src,
+             dealii::transpose_operator(prec));
+  };
+
+  initialize_inverse();
+}
+
+
+template <typename VECTOR>
+template <typename MySolver>
+void
+ParsedSolver<VECTOR>::initialize_mixed_precision_solver(MySolver *s)
+{
+  single_solver.reset(s);
+  solver.reset();
+
+  run_solver = [this, s](VECTOR &dst, const VECTOR &src) {
+    refine(op, dst, src, [this, s](SingleVector &d, const SingleVector &r) {
+      s->solve(op_single, d, r, prec_single);
+    });
+  };
+
+  run_transpose_solver = [this, s](VECTOR &dst, const VECTOR &src) {
+    op.reinit_domain_vector(dst, false);
+    refine(dealii::transpose_operator(op),
+           dst,
+           src,
+           [this, s](SingleVector &d, const SingleVector &r) {
+             s->solve(dealii::transpose_operator(op_single),
+                      d,
+                      r,
+                      dealii::transpose_operator(prec_single));
+           });
+  };
+
+  initialize_inverse();
+}
+
+
+template <typename VECTOR>
+template <template <typename> class MySolver, typename... Args>
+void
+ParsedSolver<VECTOR>::create_solver(const Args &... args)
+{
+  if (mixed_precision)
+    initialize_mixed_precision_solver(
+      new MySolver<SingleVector>(inner_control, args...));
+  else
+    initialize_solver(new MySolver<VECTOR>(control, args...));
+}
+
+
+template <typename VECTOR>
+void
+ParsedSolver<VECTOR>::initialize_inverse()
+{
+  dealii::LinearOperator<VECTOR, VECTOR> &inverse = *this;
+
+  inverse.reinit_range_vector = [this](VECTOR &v, bool omit_zeroing_entries) {
+    op.reinit_domain_vector(v, omit_zeroing_entries);
+  };
+
+  inverse.reinit_domain_vector = [this](VECTOR &v, bool omit_zeroing_entries) {
+    op.reinit_range_vector(v, omit_zeroing_entries);
+  };
+
+  inverse.vmult = [this](VECTOR &dst, const VECTOR &src) {
+    // The entries of dst are overwritten by solve() when an initial
+    // guess is computed from the history.
+    op.reinit_domain_vector(dst, initial_guess != "zero");
+    solve(dst, src);
+  };
+
+  inverse.vmult_add = [this](VECTOR &dst, const VECTOR &src) {
+    dealii::GrowingVectorMemory<VECTOR>            vector_memory;
+    typename dealii::VectorMemory<VECTOR>::Pointer tmp(vector_memory);
+    op.reinit_domain_vector(*tmp, false);
+    solve(*tmp, src);
+    dst += *tmp;
+  };
+
+  inverse.Tvmult = [this](VECTOR &dst, const VECTOR &src) {
+    run_transpose_solver(dst, src);
+  };
+
+  inverse.Tvmult_add = [this](VECTOR &dst, const VECTOR &src) {
+    dealii::GrowingVectorMemory<VECTOR>            vector_memory;
+    typename dealii::VectorMemory<VECTOR>::Pointer tmp(vector_memory);
+    run_transpose_solver(*tmp, src);
+    dst += *tmp;
+  };
+}
+
+
+template <typename VECTOR>
+void
+ParsedSolver<VECTOR>::refine(
+  const dealii::LinearOperator<VECTOR> &                           A,
+  VECTOR &                                                         x,
+  const VECTOR &                                                   b,
+  const std::function<void(SingleVector &, const SingleVector &)> &inner_solve)
+{
+  dealii::LogStream::Prefix prefix("refinement");
+
+  dealii::GrowingVectorMemory<VECTOR>                  vector_memory;
+  dealii::GrowingVectorMemory<SingleVector>            single_memory;
+  typename dealii::VectorMemory<VECTOR>::Pointer       r(vector_memory);
+  typename dealii::VectorMemory<SingleVector>::Pointer r_single(single_memory);
+  typename dealii::VectorMemory<SingleVector>::Pointer d_single(single_memory);
+  r->reinit(x, true);
+  r_single->reinit(x, true);
+  d_single->reinit(x, true);
+
+  unsigned int                 step = 0;
+  double                       res  = 0;
+  dealii::SolverControl::State conv = dealii::SolverControl::iterate;
+  while (true)
+    {
+      A.vmult(*r, x);
+      r->sadd(-1., 1., b);
+      res  = r->l2_norm();
+      conv = control.check(step, res);
+      if (conv != dealii::SolverControl::iterate)
+        break;
+
+      // A correction which does not reach the inner reduction is still
+      // useful to the outer iterations.
+      *r_single = *r;
+      *d_single = 0;
+      try
+        {
+          inner_solve(*d_single, *r_single);
+        }
+      catch (const dealii::SolverControl::NoConvergence &)
+        {}
+      *r = *d_single;
+      x += *r;
+      ++step;
+    }
+
+  AssertThrow(conv == dealii::SolverControl::success,
+              dealii::SolverControl::NoConvergence(step, res));
+}
+
+
+template <typename VECTOR>
+dealii::LinearOperator<typename ParsedSolver<VECTOR>::SingleVector>
+ParsedSolver<VECTOR>::single_precision_operator(
+  const dealii::LinearOperator<VECTOR> &double_op)
+{
+  dealii::LinearOperator<SingleVector> single_op;
+
+  single_op.reinit_range_vector = [this](SingleVector &v, bool omit) {
+    dealii::GrowingVectorMemory<VECTOR>            vector_memory;
+    typename dealii::VectorMemory<VECTOR>::Pointer tmp(vector_memory);
+    op.reinit_range_vector(*tmp, true);
+    v.reinit(*tmp, omit);
+  };
+
+  single_op.reinit_domain_vector = [this](SingleVector &v, bool omit) {
+    dealii::GrowingVectorMemory<VECTOR>            vector_memory;
+    typename dealii::VectorMemory<VECTOR>::Pointer tmp(vector_memory);
+    op.reinit_domain_vector(*tmp, true);
+    v.reinit(*tmp, omit);
+  };
+
+  // Apply double_op, or its transpose, to src converted to double.
+  const auto apply = [this, &double_op](SingleVector &      dst,
+                                        const SingleVector &src,
+                                        const bool          transpose) {
+    dealii::GrowingVectorMemory<VECTOR>            vector_memory;
+    typename dealii::VectorMemory<VECTOR>::Pointer in(vector_memory);
+    typename dealii::VectorMemory<VECTOR>::Pointer out(vector_memory);
+    (transpose ? op.reinit_range_vector : op.reinit_domain_vector)(*in, true);
+    (transpose ? op.reinit_domain_vector : op.reinit_range_vector)(*out, true);
+    *in = src;
+    if (transpose)
+      double_op.Tvmult(*out, *in);
+    else
+      double_op.vmult(*out, *in);
+    dst = *out;
+  };
+
+  single_op.vmult = [apply](SingleVector &dst, const SingleVector &src) {
+    apply(dst, src, false);
+  };
+
+  single_op.vmult_add = [apply](SingleVector &dst, const SingleVector &src) {
+    SingleVector tmp;
+    tmp.reinit(dst, true);
+    apply(tmp, src, false);
+    dst += tmp;
+  };
+
+  single_op.Tvmult = [apply](SingleVector &dst, const SingleVector &src) {
+    apply(dst, src, true);
+  };
+
+  single_op.Tvmult_add = [apply](SingleVector &dst, const SingleVector &src) {
+    SingleVector tmp;
+    tmp.reinit(dst, true);
+    apply(tmp, src, true);
+    dst += tmp;
+  };
+
+  return single_op;
+}
+
+
+template <typename VECTOR>
+void
+ParsedSolver<VECTOR>::solve(VECTOR &dst, const VECTOR &src)
+{
+  Assert(run_solver, dealii::ExcNotInitialized());
+  if (initial_guess != "zero" && !compute_initial_guess(dst))
+    dst = 0;
+  const bool tuning =
+    (solver_name == "auto" &&
+     chosen_candidate == dealii::numbers::invalid_unsigned_int);
+  if (solver_name == "auto")
+    auto_solve(dst, src);
+  else
+    run_solver(dst, src);
+  if (initial_guess != "zero")
+    store_solution(dst);
+  if (iterations_reporter && !tuning)
+    iterations_reporter(control.last_step());
+}
+
+
+template <typename VECTOR>
+template <typename PRECONDITIONER>
+void
+ParsedSolver<VECTOR>::report_iterations_to(PRECONDITIONER &preconditioner)
+{
+  iterations_reporter = [&preconditioner](const unsigned int n_iterations) {
+    preconditioner.report_iterations(n_iterations);
+  };
+}
+
+
+template <typename VECTOR>
+void
+ParsedSolver<VECTOR>::add_preconditioner_candidate(
+  const std::string &                   name,
+  const dealii::LinearOperator<VECTOR> &prec)
+{
+  preconditioner_candidates[name] = prec;
+  if (active_candidate != dealii::numbers::invalid_unsigned_int &&
+      candidates[active_candidate].preconditioner == name)
+    this->prec = prec;
+}
+
+
+template <typename VECTOR>
+void
+ParsedSolver<VECTOR>::set_tuning_communicator(const MPI_Comm &comm)
+{
+  tuning_communicator     = comm;
+  has_tuning_communicator = true;
+}
+
+
+template <typename VECTOR>
+void
+ParsedSolver<VECTOR>::select_candidate(const unsigned int i)
+{
+  AssertIndexRange(i, candidates.size());
+  initialize_solver_by_name(candidates[i].solver);
+  if (candidates[i].preconditioner != "")
+    {
+      const auto it =
+        preconditioner_candidates.find(candidates[i].preconditioner);
+      AssertThrow(it != preconditioner_candidates.end(),
+                  dealii::ExcMessage("The preconditioner \"" +
+                                     candidates[i].preconditioner +
+                                     "\" was not registered with "
+                                     "add_preconditioner_candidate()."));
+      prec = it->second;
+    }
+  active_candidate = i;
+}
+
+
+template <typename VECTOR>
+void
+ParsedSolver<VECTOR>::auto_solve(VECTOR &dst, const VECTOR &src)
+{
+  if (chosen_candidate != dealii::numbers::invalid_unsigned_int)
+    {
+      if (active_candidate != chosen_candidate)
+        select_candidate(chosen_candidate);
+      run_solver(dst, src);
+      return;
+    }
+
+  const MPI_Comm comm = has_tuning_communicator ?
+                          tuning_communicator :
+                          internal::vector_communicator(src, 0);
+
+  // All the candidates solve this system from the same initial guess,
+  // and dst takes the solution of the fastest one.
+  const VECTOR guess(dst);
+  VECTOR       x(dst);
+  unsigned int fastest   = dealii::numbers::invalid_unsigned_int;
+  double       best_time = std::numeric_limits<double>::max();
+  for (unsigned int i = 0; i < candidates.size(); ++i)
+    {
+      Candidate &candidate = candidates[i];
+      if (candidate.failed)
+        continue;
+
+      select_candidate(i);
+      x = guess;
+
+      const auto start = std::chrono::steady_clock::now();
+      try
+        {
+          run_solver(x, src);
+        }
+      catch (const dealii::SolverControl::NoConvergence &)
+        {
+          candidate.failed = true;
+          continue;
+        }
+      const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+      const double time = dealii::Utilities::MPI::max(elapsed.count(), comm);
+      candidate.time += time;
+      candidate.iterations += control.last_step();
+      ++candidate.n_solves;
+
+      if (time < best_time)
+        {
+          best_time = time;
+          fastest   = i;
+          dst       = x;
+        }
+    }
+  AssertThrow(fastest != dealii::numbers::invalid_unsigned_int,
+              dealii::ExcMessage("None of the candidates of the auto "
+                                 "solver converged."));
+
+  if (candidates[fastest].n_solves == auto_tuning_solves)
+    choose_candidate(comm);
+}
+
+
+template <typename VECTOR>
+void
+ParsedSolver<VECTOR>::choose_candidate(const MPI_Comm &comm)
+{
+  double best_time = std::numeric_limits<double>::max();
+  for (unsigned int i = 0; i < candidates.size(); ++i)
+    if (!candidates[i].failed && candidates[i].n_solves > 0 &&
+        candidates[i].time / candidates[i].n_solves < best_time)
+      {
+        best_time        = candidates[i].time / candidates[i].n_solves;
+        chosen_candidate = i;
+      }
+  AssertThrow(chosen_candidate != dealii::numbers::invalid_unsigned_int,
+              dealii::ExcMessage("None of the candidates of the auto "
+                                 "solver converged."));
+
+  const Candidate &chosen = candidates[chosen_candidate];
+  dealii::deallog << "Auto solver: " << chosen.solver
+                  << (chosen.preconditioner != "" ? " with " : "")
+                  << chosen.preconditioner << std::endl;
+
+  if (auto_tuning_file != "" &&
+      dealii::Utilities::MPI::this_mpi_process(comm) == 0)
+    {
+      std::ofstream out(auto_tuning_file);
+      out << "# candidate: solves, iterations, seconds" << std::endl;
+      for (const auto &c : candidates)
+        out << "# " << c.solver << " " << c.preconditioner << ": "
+            << c.n_solves << ", " << c.iterations << ", "
+            << (c.failed ? "not converged" : std::to_string(c.time))
+            << std::endl;
+      out << "solver = " << chosen.solver << std::endl
+          << "preconditioner = " << chosen.preconditioner << std::endl;
+    }
+}
+
+
+template <typename VECTOR>
+bool
+ParsedSolver<VECTOR>::read_tuning_file()
+{
+  if (auto_tuning_file == "" || !file_exists(auto_tuning_file))
+    return false;
+
+  std::ifstream in(auto_tuning_file);
+  std::string   line, solver, preconditioner;
+  while (std::getline(in, line))
+    {
+      const auto pos = line.find('=');
+      if (line.empty() || line[0] == '#' || pos == std::string::npos)
+        continue;
+      const std::string key   = dealii::Utilities::trim(line.substr(0, pos));
+      const std::string value = dealii::Utilities::trim(line.substr(pos + 1));
+      if (key == "solver")
+        solver = value;
+      else if (key == "preconditioner")
+        preconditioner = value;
+    }
+
+  for (unsigned int i = 0; i < candidates.size(); ++i)
+    if (candidates[i].solver == solver &&
+        candidates[i].preconditioner == preconditioner)
+      {
+        chosen_candidate = i;
+        return true;
+      }
+  return false;
+}
+
+
+template <typename VECTOR>
+void
+ParsedSolver<VECTOR>::clear_history()
+{
+  history.clear();
+  if (clear_recycled_subspace)
+    clear_recycled_subspace();
+}
+
+
+template <typename VECTOR>
+void
+ParsedSolver<VECTOR>::set_operator(
+  const dealii::LinearOperator<VECTOR> &new_op)
+{
+  op = new_op;
+  if (clear_recycled_subspace)
+    clear_recycled_subspace();
+}
+
+
+template <typename VECTOR>
+bool
+ParsedSolver<VECTOR>::compute_initial_guess(VECTOR &dst) const
+{
+  const unsigned int n = history.size();
+  if (n == 0 || history.back().size() != dst.size())
+    return false;
+
+  // Use the highest order allowed by both the parameter and the number
+  // of stored solutions.
+  if (initial_guess == "quadratic extrapolation" && n >= 3)
+    {
+      // 3 x_{n-1} - 3 x_{n-2} + x_{n-3}
+      dst = history[n - 3];
+      dst.add(3.0, history[n - 1], -3.0, history[n - 2]);
+    }
+  else if (initial_guess != "last solution" && n >= 2)
+    {
+      // 2 x_{n-1} - x_{n-2}
+      dst = history[n - 1];
+      dst.sadd(2.0, -1.0, history[n - 2]);
+    }
+  else
+    dst = history[n - 1];
+  return true;
+}
+
+
+template <typename VECTOR>
+void
+ParsedSolver<VECTOR>::store_solution(const VECTOR &solution)
+{
+  const unsigned int max_size = (initial_guess == "last solution")        ? 1 :
+                                (initial_guess == "linear extrapolation") ? 2 :
+                                                                            3;
+  if (!history.empty() && history.back().size() != solution.size())
+    history.clear();
+
+  if (history.size() == max_size)
+    {
+      // Recycle the memory of the oldest solution.
+      history.push_back(std::move(history.front()));
+      history.pop_front();
+      history.back() = solution;
+    }
+  else
+    history.push_back(solution);
+
+  while (history.size() > max_size)
+    history.pop_front();
 }
 
 template <typename VECTOR>
 void
 ParsedSolver<VECTOR>::parse_parameters_call_back()
 {
-  if (solver_name == "cg")
+  inner_control = dealii::ReductionControl(
+    control.max_steps(), 0.0, inner_reduction, false, false);
+
+  if (solver_name == "auto")
+    {
+      candidates.clear();
+      chosen_candidate = dealii::numbers::invalid_unsigned_int;
+      active_candidate = dealii::numbers::invalid_unsigned_int;
+      for (const auto &solver : auto_solvers)
+        if (auto_preconditioners.empty())
+          candidates.push_back({solver, ""});
+        else
+          for (const auto &preconditioner : auto_preconditioners)
+            candidates.push_back({solver, preconditioner});
+
+      read_tuning_file();
+      // The preconditioners may not be registered yet: they are set at
+      // the first solve.
+      initialize_solver_by_name(
+        candidates[chosen_candidate == dealii::numbers::invalid_unsigned_int ?
+                     0 :
+                     chosen_candidate]
+          .solver);
+    }
+  else
+    initialize_solver_by_name(solver_name);
+}
+
+
+template <typename VECTOR>
+void
+ParsedSolver<VECTOR>::initialize_solver_by_name(const std::string &name)
+{
+  clear_recycled_subspace = nullptr;
+
+  if (name == "cg")
+    {
+      create_solver<dealii::SolverCG>();
+    }
+  else if (name == "deflated-cg" && mixed_precision)
+    {
+      auto s = new SolverDeflatedCG<SingleVector>(inner_control,
+                                                  recycled_dimension,
+                                                  recycled_constant_operator);
+      clear_recycled_subspace = [s]() { s->clear_subspace(); };
+      initialize_mixed_precision_solver(s);
+    }
+  else if (name == "deflated-cg")
+    {
+      auto s = new SolverDeflatedCG<VECTOR>(control,
+                                            recycled_dimension,
+                                            recycled_constant_operator);
+      clear_recycled_subspace = [s]() { s->clear_subspace(); };
+      initialize_solver(s);
+    }
+  else if (name == "pipelined-cg")
+    {
+      create_solver<SolverPipelinedCG>();
+    }
+  else if (name == "bicgstab")
     {
-      initialize_solver(new dealii::SolverCG<VECTOR>(control));
+      create_solver<dealii::SolverBicgstab>();
     }
-  else if (solver_name == "bicgstab")
+  else if (name == "gmres")
     {
-      initialize_solver(new dealii::SolverBicgstab<VECTOR>(control));
+      create_solver<dealii::SolverGMRES>();
     }
-  else if (solver_name == "gmres")
+  else if (name == "fgmres")
     {
-      initialize_solver(new dealii::SolverGMRES<VECTOR>(control));
+      create_solver<dealii::SolverFGMRES>();
     }
-  else if (solver_name == "fgmres")
+  else if (name == "s-step gmres")
     {
-      initialize_solver(new dealii::SolverFGMRES<VECTOR>(control));
+      create_solver<SolverSStepGMRES>(s_step_size);
     }
-  else if (solver_name == "minres")
+  else if (name == "minres")
     {
-      initialize_solver(new dealii::SolverMinRes<VECTOR>(control));
+      create_solver<dealii::SolverMinRes>();
     }
-  else if (solver_name == "qmrs")
+  else if (name == "qmrs")
     {
-      initialize_solver(new dealii::SolverQMRS<VECTOR>(control));
+      create_solver<dealii::SolverQMRS>();
     }
-  else if (solver_name == "richardson")
+  else if (name == "richardson")
     {
-      initialize_solver(new dealii::SolverRichardson<VECTOR>(control));
+      create_solver<dealii::SolverRichardson>();
     }
   else
     {
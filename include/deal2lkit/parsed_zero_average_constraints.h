@@ -17,11 +17,15 @@
 #define d2k_parsed_zero_average_constraints_h
 
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/index_set.h>
 #include <deal.II/base/parsed_function.h>
 
 #include <deal.II/dofs/dof_handler.h>
 
 #include <deal.II/fe/component_mask.h>
+#include <deal.II/fe/mapping_q1.h>
+
+#include <deal.II/lac/linear_operator.h>
 
 // old versions of dealii use ConstraintMatrix but the new versions
 // have switched to AffineConstraints<double>
@@ -51,6 +55,7 @@ namespace dealii
 
 #include <algorithm>
 #include <map>
+#include <memory>
 
 
 D2K_NAMESPACE_OPEN
@@ -79,6 +84,31 @@ D2K_NAMESPACE_OPEN
  * ParameterAcceptor::initialize();
  * pnac.apply_zero_average_constraints(dof_handler,cm);
  * @endcode
+ *
+ * The default "Zero average method" (i.e., "constraints") adds to the
+ * constraint matrix one line that couples the first dof of the
+ * selected component with all the others. This produces a dense row
+ * in the assembled matrix. If the method is set to "projection", no
+ * constraint is added, and the zero mean value is instead enforced by
+ * the rank-one, mass-weighted projection
+ *
+ * \f[ P u = u - \frac{w \cdot u}{w \cdot 1} 1 \f]
+ *
+ * where \f$w_i = \int \phi_i\f$ (on the whole domain or on the
+ * boundary) and \f$1\f$ is the vector representing the constant
+ * function of the selected component. The projection is applied to the
+ * solver (or to the preconditioner) of the singular system, so that
+ * the assembled matrix stays sparse:
+ *
+ * @code
+ * pnac.compute_mean_value_projection(dof_handler, mapping);
+ *
+ * ParsedSolver<VEC> Ainv;
+ * ...
+ * auto Ainv_zero_average = pnac.zero_average_operator<VEC>(Ainv);
+ *
+ * x = Ainv_zero_average*b;
+ * @endcode
  */
 
 
@@ -123,6 +153,47 @@ public:
     dealii::AffineConstraints<double> &      constraints) const;
 
 
+  /**
+   * Compute the mass-weighted mean value functionals of all the
+   * components selected in the parameter file, as required by
+   * mean_value_projection() and zero_average_operator(). This function
+   * must be called every time the DoFHandler changes.
+   *
+   * Only the locally owned dofs are stored, so that this function can
+   * be used with parallel::distributed::Triangulation objects.
+   */
+  void
+  compute_mean_value_projection(
+    const dealii::DoFHandler<dim, spacedim> &dof_handler,
+    const dealii::Mapping<dim, spacedim> &   mapping =
+      dealii::StaticMappingQ1<dim, spacedim>::mapping);
+
+
+  /**
+   * Return the LinearOperator \f$P\f$ that removes the mean value of
+   * the selected components, and whose transpose \f$P^T\f$ removes
+   * from a right hand side the part that is not in the range of a
+   * matrix having the constants in its kernel.
+   *
+   * The reinit functions of the projection are taken from @p op, as in
+   * dealii::identity_operator(). compute_mean_value_projection() must
+   * have been called before.
+   */
+  template <typename VECTOR>
+  dealii::LinearOperator<VECTOR>
+  mean_value_projection(const dealii::LinearOperator<VECTOR> &op) const;
+
+
+  /**
+   * Return \f$P A^{-1} P^T\f$, where @p inverse is either a solver or
+   * a preconditioner for a matrix whose kernel are the constants of the
+   * selected components. The result always has zero mean value.
+   */
+  template <typename VECTOR>
+  dealii::LinearOperator<VECTOR>
+  zero_average_operator(const dealii::LinearOperator<VECTOR> &inverse) const;
+
+
   /**
    * return the ComponentMask at boundary
    */
@@ -166,6 +237,11 @@ public:
                  << " does not belong to the knwon variables: "
                  << print(unique(arg2)) << ".");
 
+  /// Projection not computed
+  DeclExceptionMsg(ExcProjectionNotComputed,
+                   "You have to call compute_mean_value_projection() "
+                   "before asking for the projection operator.");
+
 protected:
   void
   internal_zero_average_constraints(
@@ -186,9 +262,128 @@ protected:
   std::vector<bool> boundary_mask;
 
   const unsigned int n_components;
+
+  /**
+   * Either "constraints" or "projection".
+   */
+  std::string method;
+
+  /**
+   * Whether compute_mean_value_projection() has been called.
+   */
+  bool projection_computed;
+
+  /**
+   * Locally owned dofs of each of the constrained components. These
+   * are the entries of the vectors representing the constants.
+   */
+  std::vector<dealii::IndexSet> projection_dofs;
+
+  /**
+   * Weights of the mean value functional of each of the constrained
+   * components, ordered as the elements of the corresponding
+   * projection_dofs.
+   */
+  std::vector<std::vector<double>> projection_weights;
 };
 
 
+// ============================================================
+// Template specializations
+// ============================================================
+
+template <int dim, int spacedim>
+template <typename VECTOR>
+dealii::LinearOperator<VECTOR>
+ParsedZeroAverageConstraints<dim, spacedim>::mean_value_projection(
+  const dealii::LinearOperator<VECTOR> &op) const
+{
+  AssertThrow(projection_computed, ExcProjectionNotComputed());
+
+  // The vectors representing the functionals and the constants are
+  // only built the first time the operator is applied, since only then
+  // we know the layout of the vectors.
+  struct Functional
+  {
+    VECTOR w;
+    VECTOR one;
+    double w_dot_one;
+  };
+
+  const auto dofs      = projection_dofs;
+  const auto weights   = projection_weights;
+  auto       functions = std::make_shared<std::vector<Functional>>();
+
+  const auto initialize = [dofs, weights, functions](const VECTOR &v) {
+    if (!functions->empty() && functions->front().w.size() == v.size())
+      return;
+
+    functions->resize(dofs.size());
+    for (unsigned int c = 0; c < dofs.size(); ++c)
+      {
+        Functional &f = (*functions)[c];
+        f.w.reinit(v);
+        f.one.reinit(v);
+
+        unsigned int k = 0;
+        for (auto i : dofs[c])
+          {
+            f.w(i)   = weights[c][k++];
+            f.one(i) = 1.0;
+          }
+        f.w.compress(dealii::VectorOperation::insert);
+        f.one.compress(dealii::VectorOperation::insert);
+
+        f.w_dot_one = f.w * f.one;
+        Assert(f.w_dot_one > 0, dealii::ExcInternalError());
+      }
+  };
+
+  dealii::LinearOperator<VECTOR> P = dealii::identity_operator(op);
+
+  P.vmult = [initialize, functions](VECTOR &dst, const VECTOR &src) {
+    initialize(src);
+    dst = src;
+    for (const auto &f : *functions)
+      dst.add(-(f.w * src) / f.w_dot_one, f.one);
+  };
+
+  P.vmult_add = [initialize, functions](VECTOR &dst, const VECTOR &src) {
+    initialize(src);
+    dst += src;
+    for (const auto &f : *functions)
+      dst.add(-(f.w * src) / f.w_dot_one, f.one);
+  };
+
+  P.Tvmult = [initialize, functions](VECTOR &dst, const VECTOR &src) {
+    initialize(src);
+    dst = src;
+    for (const auto &f : *functions)
+      dst.add(-(f.one * src) / f.w_dot_one, f.w);
+  };
+
+  P.Tvmult_add = [initialize, functions](VECTOR &dst, const VECTOR &src) {
+    initialize(src);
+    dst += src;
+    for (const auto &f : *functions)
+      dst.add(-(f.one * src) / f.w_dot_one, f.w);
+  };
+
+  return P;
+}
+
+
+template <int dim, int spacedim>
+template <typename VECTOR>
+dealii::LinearOperator<VECTOR>
+ParsedZeroAverageConstraints<dim, spacedim>::zero_average_operator(
+  const dealii::LinearOperator<VECTOR> &inverse) const
+{
+  const auto P = mean_value_projection(inverse);
+  return P * inverse * dealii::transpose_operator(P);
+}
+
+
 
 D2K_NAMESPACE_CLOSE
 
@@ -0,0 +1,352 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+#ifndef d2k_point_locator_h
+#define d2k_point_locator_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/base/smartpointer.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q1.h>
+
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal2lkit/config.h>
+#include <deal2lkit/utilities.h>
+
+#include <external/nanoflann.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+
+D2K_NAMESPACE_OPEN
+
+/**
+ * Fast point location and batched point evaluation.
+ *
+ * This class builds a KD-tree (using the bundled nanoflann library)
+ * over the vertices of the locally owned active cells of the
+ * triangulation of a DoFHandler. The cell containing a point is then
+ * searched only among the cells around the closest vertices, instead
+ * of looping over all the cells as done by VectorTools::point_value().
+ *
+ * The index is built the first time it is needed, and it is rebuilt
+ * lazily after the triangulation signals any change.
+ *
+ * A typical usage of this class is as follows:
+ *
+ * @code
+ * PointLocator<dim> locator(dof_handler, mapping);
+ *
+ * std::vector<Point<dim>> probes = ...;
+ *
+ * // every process gets the values at all the probes
+ * std::vector<Vector<double>> values =
+ *   locator.evaluate(probes, locally_relevant_solution);
+ * @endcode
+ *
+ * With a parallel::distributed::Triangulation, every point is
+ * evaluated by the process owning the cell that contains it, and the
+ * results are then shared with all the processes of the communicator
+ * of the triangulation. In this case, the solution vector must
+ * contain the ghost values.
+ */
+template <int dim, int spacedim = dim>
+class PointLocator
+{
+public:
+  /**
+   * Active cell iterator of the DoFHandler.
+   */
+  using active_cell_iterator =
+    typename dealii::DoFHandler<dim, spacedim>::active_cell_iterator;
+
+  /**
+   * Constructor. The DoFHandler and the Mapping must live longer than
+   * this object.
+   */
+  PointLocator(const dealii::DoFHandler<dim, spacedim> &dof_handler,
+               const dealii::Mapping<dim, spacedim> &   mapping =
+                 dealii::StaticMappingQ1<dim, spacedim>::mapping);
+
+  /**
+   * Destructor. Disconnect from the signals of the triangulation.
+   */
+  ~PointLocator();
+
+  /**
+   * Return, for each of the given @p points, a locally owned cell
+   * containing it and the coordinates of the point on the reference
+   * cell. If the point is not inside any of the locally owned cells,
+   * the returned iterator is equal to dof_handler.end().
+   *
+   * In parallel, a point lying on the interface between two processes
+   * is assigned to the one with the lowest rank, so that every point
+   * of the mesh is located by exactly one process.
+   */
+  std::vector<std::pair<active_cell_iterator, dealii::Point<dim>>>
+  locate(const std::vector<dealii::Point<spacedim>> &points) const;
+
+  /**
+   * Evaluate all the components of @p solution at the given @p points.
+   * The returned values are the same on all processes. An exception
+   * is thrown if a point is not inside the mesh.
+   *
+   * The values of elements like FE_Q, which do not depend on the
+   * mapping, are computed from the shape functions on the reference
+   * cell, without building any FEValues object.
+   */
+  template <typename VECTOR>
+  std::vector<dealii::Vector<double>>
+  evaluate(const std::vector<dealii::Point<spacedim>> &points,
+           const VECTOR &                              solution) const;
+
+  /**
+   * Mark the index as outdated. It will be rebuilt at the next query.
+   * This is called automatically when the triangulation changes, but
+   * it must be called by hand when the mapping moves the vertices, as
+   * for MappingQEulerian.
+   */
+  void
+  clear();
+
+  /// Point outside the mesh
+  DeclException1(ExcPointNotFound,
+                 dealii::Point<spacedim>,
+                 << "The point " << arg1 << " is not inside the mesh.");
+
+private:
+  /**
+   * Adaptor of the vertices to the interface required by nanoflann.
+   */
+  struct VertexCloud
+  {
+    inline size_t
+    kdtree_get_point_count() const
+    {
+      return points.size();
+    }
+
+    inline double
+    kdtree_distance(const double *p1, const size_t idx_p2, size_t size) const
+    {
+      double s = 0;
+      for (size_t d = 0; d < size; ++d)
+        {
+          const double diff = p1[d] - points[idx_p2][d];
+          s += diff * diff;
+        }
+      return s;
+    }
+
+    inline double
+    kdtree_get_pt(const size_t idx, int d) const
+    {
+      return points[idx][d];
+    }
+
+    template <class BBOX>
+    bool
+    kdtree_get_bbox(BBOX &) const
+    {
+      return false;
+    }
+
+    /**
+     * Position of the vertices.
+     */
+    std::vector<dealii::Point<spacedim>> points;
+
+    /**
+     * Locally owned active cells sharing each vertex.
+     */
+    std::vector<std::vector<active_cell_iterator>> cells;
+  };
+
+  using KDTree = nanoflann::KDTreeSingleIndexAdaptor<
+    nanoflann::L2_Simple_Adaptor<double, VertexCloud>,
+    VertexCloud,
+    spacedim,
+    unsigned int>;
+
+  /**
+   * Build the KD-tree, if it is not up to date.
+   */
+  void
+  build_index() const;
+
+  /**
+   * Find a locally owned cell containing @p p. Return dof_handler.end()
+   * if no such cell is found. Points far from all the locally owned
+   * vertices are rejected without searching, so that the points owned
+   * by other processes are cheap to discard. The others are searched
+   * among the cells around the closest vertices, and then among their
+   * neighbors, but never in the whole mesh.
+   */
+  std::pair<active_cell_iterator, dealii::Point<dim>>
+  find_cell(const dealii::Point<spacedim> &p) const;
+
+  /**
+   * The DoFHandler.
+   */
+  dealii::SmartPointer<const dealii::DoFHandler<dim, spacedim>> dof_handler;
+
+  /**
+   * The Mapping.
+   */
+  dealii::SmartPointer<const dealii::Mapping<dim, spacedim>> mapping;
+
+  /**
+   * Communicator of the triangulation.
+   */
+  MPI_Comm comm;
+
+  /**
+   * Connection to the any_change signal of the triangulation.
+   */
+  boost::signals2::connection tria_connection;
+
+  /**
+   * Vertices indexed by the KD-tree.
+   */
+  mutable VertexCloud vertices;
+
+  /**
+   * Index in vertices of each vertex of the triangulation, or
+   * numbers::invalid_unsigned_int if it is not a vertex of a locally
+   * owned cell.
+   */
+  mutable std::vector<unsigned int> vertex_index;
+
+  /**
+   * The KD-tree. Empty if the index is outdated.
+   */
+  mutable std::unique_ptr<KDTree> kdtree;
+
+  /**
+   * Largest distance between two mapped vertices of a locally owned
+   * cell. A point farther than this from all the indexed vertices is not
+   * inside any locally owned cell.
+   */
+  mutable double max_cell_diameter;
+};
+
+
+// ============================================================
+// Template specializations
+// ============================================================
+
+template <int dim, int spacedim>
+template <typename VECTOR>
+std::vector<dealii::Vector<double>>
+PointLocator<dim, spacedim>::evaluate(
+  const std::vector<dealii::Point<spacedim>> &points,
+  const VECTOR &                              solution) const
+{
+  const auto located = locate(points);
+
+  const dealii::FiniteElement<dim, spacedim> &fe = dof_handler->get_fe();
+  const unsigned int n_components                = fe.n_components();
+
+  // Group the points by cell, so that FEValues is reinitialized once
+  // per cell.
+  std::map<active_cell_iterator, std::vector<unsigned int>> points_per_cell;
+  for (unsigned int i = 0; i < points.size(); ++i)
+    if (located[i].first != dof_handler->end())
+      points_per_cell[located[i].first].push_back(i);
+
+  std::vector<double> local_values(points.size() * n_components, 0.0);
+  std::vector<double> local_found(points.size(), 0.0);
+
+  // The values of the elements which do not depend on the mapping, as
+  // the Lagrange ones, are computed directly from the shape functions
+  // on the reference cell. The others need an FEValues object for each
+  // cell.
+  const bool reference_values =
+    fe.is_primitive() &&
+    fe.requires_update_flags(dealii::update_values) == dealii::update_values;
+
+  dealii::Vector<double> dof_values(fe.dofs_per_cell);
+  for (const auto &cell_points : points_per_cell)
+    {
+      if (reference_values)
+        {
+          cell_points.first->get_dof_values(solution, dof_values);
+          for (const auto i : cell_points.second)
+            {
+              for (unsigned int k = 0; k < fe.dofs_per_cell; ++k)
+                local_values[i * n_components +
+                             fe.system_to_component_index(k).first] +=
+                  dof_values[k] * fe.shape_value(k, located[i].second);
+              local_found[i] = 1.0;
+            }
+          continue;
+        }
+
+      std::vector<dealii::Point<dim>> unit_points;
+      for (const auto i : cell_points.second)
+        unit_points.push_back(located[i].second);
+
+      const dealii::Quadrature<dim>     quadrature(unit_points);
+      dealii::FEValues<dim, spacedim> fe_values(*mapping,
+                                                fe,
+                                                quadrature,
+                                                dealii::update_values);
+      fe_values.reinit(cell_points.first);
+
+      std::vector<dealii::Vector<double>> values(
+        unit_points.size(), dealii::Vector<double>(n_components));
+      fe_values.get_function_values(solution, values);
+
+      for (unsigned int q = 0; q < unit_points.size(); ++q)
+        {
+          const unsigned int i = cell_points.second[q];
+          for (unsigned int c = 0; c < n_components; ++c)
+            local_values[i * n_components + c] = values[q][c];
+          local_found[i] = 1.0;
+        }
+    }
+
+  std::vector<double> global_values(local_values.size());
+  std::vector<double> found(local_found.size());
+  dealii::Utilities::MPI::sum(local_values, comm, global_values);
+  dealii::Utilities::MPI::sum(local_found, comm, found);
+
+  std::vector<dealii::Vector<double>> result(
+    points.size(), dealii::Vector<double>(n_components));
+  for (unsigned int i = 0; i < points.size(); ++i)
+    {
+      AssertThrow(found[i] > 0, ExcPointNotFound(points[i]));
+      for (unsigned int c = 0; c < n_components; ++c)
+        result[i][c] = global_values[i * n_components + c];
+    }
+  return result;
+}
+
+D2K_NAMESPACE_CLOSE
+
+#endif
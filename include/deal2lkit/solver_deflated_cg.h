@@ -0,0 +1,464 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+#ifndef d2k_solver_deflated_cg_h
+#define d2k_solver_deflated_cg_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/logstream.h>
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/lapack_full_matrix.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/vector_memory.h>
+
+#include <deal2lkit/config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+
+D2K_NAMESPACE_OPEN
+
+/**
+ * Preconditioned conjugate gradients with deflation of a recycled
+ * subspace, for sequences of slowly varying symmetric positive definite
+ * systems.
+ *
+ * The solver keeps a subspace W of approximate eigenvectors of the
+ * operator associated to its smallest eigenvalues. Every solve starts
+ * from the Galerkin correction of the initial guess on W, and the
+ * search directions are kept A-orthogonal to W, so that the conjugate
+ * gradients do not spend iterations to rediscover the slow modes
+ * (Saad, Yeung, Erhel, Guyomarc'h, SIAM J. Sci. Comput. 21, 2000).
+ *
+ * During the solve, a copy of W is updated every 2 x
+ * subspace_dimension iterations with the Ritz vectors associated to
+ * the smallest Ritz values of the operator in the space spanned by the
+ * copy and by the last search directions, in the spirit of eigCG
+ * (Stathopoulos, Orginos, SIAM J. Sci. Comput. 32, 2010). The products
+ * of the operator with the search directions are already available, so
+ * no additional applications of the operator are needed. The copy
+ * replaces W at the end of the solve.
+ *
+ * By default, the products of the operator with W are recomputed at
+ * the beginning of each solve, so that the deflation is exact also when
+ * the operator changes between solves. This costs one application of
+ * the operator per recycled vector and per solve. When the operator is
+ * the same for all the solves, set @p constant_operator in the
+ * constructor: the products computed during the previous solve are
+ * reused, and no additional applications of the operator are needed at
+ * all, as long as solve() is called with the same operator object. They
+ * are recomputed when a different object is passed, but not when the
+ * same object changes: call clear_subspace() in that case.
+ *
+ * The subspace is discarded when the size of the vectors changes, when
+ * clear_subspace() is called, and, when the products are recomputed,
+ * if the Rayleigh quotients of the recycled vectors moved from their
+ * Ritz values by more than half the largest Ritz value. This heuristic
+ * detects an operator which is very different from the one the
+ * subspace was built for, but not a small change.
+ */
+template <typename VECTOR>
+class SolverDeflatedCG : public dealii::Solver<VECTOR>
+{
+public:
+  /**
+   * Constructor. The recycled subspace has at most
+   * @p subspace_dimension vectors. If @p constant_operator is true, all
+   * the solves must use the same operator.
+   */
+  SolverDeflatedCG(dealii::SolverControl &       cn,
+                   dealii::VectorMemory<VECTOR> &mem,
+                   const unsigned int            subspace_dimension = 8,
+                   const bool                    constant_operator  = false);
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default
+   * to allocate memory.
+   */
+  SolverDeflatedCG(dealii::SolverControl &cn,
+                   const unsigned int     subspace_dimension = 8,
+                   const bool             constant_operator  = false);
+
+  /**
+   * Solve the linear system $Ax=b$ for x, starting from the content of
+   * x, and update the recycled subspace.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve(const MatrixType &        A,
+        VECTOR &                  x,
+        const VECTOR &            b,
+        const PreconditionerType &preconditioner);
+
+  /**
+   * Discard the recycled subspace.
+   */
+  void
+  clear_subspace();
+
+  /**
+   * Number of vectors currently in the recycled subspace.
+   */
+  unsigned int
+  subspace_size() const;
+
+private:
+  /**
+   * Replace @p U with the Ritz vectors of the smallest Ritz values in
+   * the span of @p U and @p P, given the products @p AU and @p AP of the
+   * operator with them. The Ritz values are stored in @p theta, and
+   * @p P and @p AP are emptied.
+   */
+  void
+  compress(std::vector<VECTOR> &U,
+           std::vector<VECTOR> &AU,
+           std::vector<double> &theta,
+           std::vector<VECTOR> &P,
+           std::vector<VECTOR> &AP) const;
+
+  /**
+   * Maximum dimension of the recycled subspace.
+   */
+  const unsigned int subspace_dimension;
+
+  /**
+   * Whether the operator is the same for all the solves, so that AW can
+   * be reused.
+   */
+  const bool constant_operator;
+
+  /**
+   * The recycled subspace, made of unit vectors.
+   */
+  std::vector<VECTOR> W;
+
+  /**
+   * The products of the operator of the last solve with W.
+   */
+  std::vector<VECTOR> AW;
+
+  /**
+   * The Ritz values of the vectors in W, when they were computed.
+   */
+  std::vector<double> ritz_values;
+
+  /**
+   * The operator of the last solve, which AW was computed with.
+   */
+  const void *last_operator = nullptr;
+};
+
+// ============================================================
+// Explicit template functions
+// ============================================================
+
+template <typename VECTOR>
+SolverDeflatedCG<VECTOR>::SolverDeflatedCG(
+  dealii::SolverControl &       cn,
+  dealii::VectorMemory<VECTOR> &mem,
+  const unsigned int            subspace_dimension,
+  const bool                    constant_operator)
+  : dealii::Solver<VECTOR>(cn, mem)
+  , subspace_dimension(subspace_dimension)
+  , constant_operator(constant_operator)
+{}
+
+
+template <typename VECTOR>
+SolverDeflatedCG<VECTOR>::SolverDeflatedCG(
+  dealii::SolverControl &cn,
+  const unsigned int     subspace_dimension,
+  const bool             constant_operator)
+  : dealii::Solver<VECTOR>(cn)
+  , subspace_dimension(subspace_dimension)
+  , constant_operator(constant_operator)
+{}
+
+
+template <typename VECTOR>
+void
+SolverDeflatedCG<VECTOR>::clear_subspace()
+{
+  W.clear();
+  AW.clear();
+  ritz_values.clear();
+}
+
+
+template <typename VECTOR>
+unsigned int
+SolverDeflatedCG<VECTOR>::subspace_size() const
+{
+  return W.size();
+}
+
+
+template <typename VECTOR>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverDeflatedCG<VECTOR>::solve(const MatrixType &        A,
+                                VECTOR &                  x,
+                                const VECTOR &            b,
+                                const PreconditionerType &preconditioner)
+{
+  dealii::LogStream::Prefix prefix("deflated-cg");
+
+  if (!W.empty() && W[0].size() != x.size())
+    clear_subspace();
+
+  // Products of the current operator with the recycled subspace. If the
+  // Rayleigh quotients moved far from the Ritz values, the operator is
+  // not the one the subspace was built for.
+  if (!constant_operator || AW.size() != W.size() ||
+      last_operator != static_cast<const void *>(&A))
+    {
+      AW.resize(W.size());
+      for (unsigned int i = 0; i < W.size(); ++i)
+        {
+          AW[i].reinit(W[i], true);
+          A.vmult(AW[i], W[i]);
+          const double rayleigh_quotient = W[i] * AW[i];
+          if (!(std::abs(rayleigh_quotient - ritz_values[i]) <=
+                0.5 * ritz_values.back()))
+            {
+              clear_subspace();
+              break;
+            }
+        }
+    }
+
+  const unsigned int         k = W.size();
+  dealii::FullMatrix<double> E_inverse(k, k);
+  if (k > 0)
+    {
+      dealii::FullMatrix<double> E(k, k);
+      for (unsigned int i = 0; i < k; ++i)
+        for (unsigned int j = 0; j < k; ++j)
+          E(i, j) = W[i] * AW[j];
+      E_inverse.invert(E);
+    }
+
+  // Subtract from v its component along W, in the inner product given
+  // by the operator: v -= W E^{-1} (AW)^T v.
+  dealii::Vector<double> c(k), projection(k);
+  const auto             deflate = [&](VECTOR &v) {
+    for (unsigned int i = 0; i < k; ++i)
+      c[i] = AW[i] * v;
+    E_inverse.vmult(projection, c);
+    for (unsigned int i = 0; i < k; ++i)
+      v.add(-projection[i], W[i]);
+  };
+
+  typename dealii::VectorMemory<VECTOR>::Pointer r(this->memory);
+  typename dealii::VectorMemory<VECTOR>::Pointer z(this->memory);
+  typename dealii::VectorMemory<VECTOR>::Pointer p(this->memory);
+  typename dealii::VectorMemory<VECTOR>::Pointer q(this->memory);
+  r->reinit(x, true);
+  z->reinit(x, true);
+  p->reinit(x, true);
+  q->reinit(x, true);
+
+  A.vmult(*r, x);
+  r->sadd(-1., 1., b);
+
+  // Galerkin correction of the initial guess on W, which makes the
+  // residual orthogonal to W.
+  if (k > 0)
+    {
+      for (unsigned int i = 0; i < k; ++i)
+        c[i] = W[i] * (*r);
+      E_inverse.vmult(projection, c);
+      for (unsigned int i = 0; i < k; ++i)
+        {
+          x.add(projection[i], W[i]);
+          r->add(-projection[i], AW[i]);
+        }
+    }
+
+  // The next recycled subspace, and the last search directions,
+  // normalized, with their products with the operator.
+  const unsigned int  window = 2 * subspace_dimension;
+  std::vector<VECTOR> U(W), AU(AW), P, AP;
+  std::vector<double> theta(ritz_values);
+
+  unsigned int                  step = 0;
+  double                        res  = r->l2_norm();
+  dealii::SolverControl::State conv = this->iteration_status(step, res, x);
+
+  if (conv == dealii::SolverControl::iterate)
+    {
+      preconditioner.vmult(*z, *r);
+      *p = *z;
+      deflate(*p);
+      double rz = (*r) * (*z);
+
+      while (conv == dealii::SolverControl::iterate)
+        {
+          ++step;
+
+          A.vmult(*q, *p);
+          const double pq = (*p) * (*q);
+          Assert(pq > 0, dealii::ExcMessage("The operator is not positive."));
+          const double alpha = rz / pq;
+
+          const double norm = p->l2_norm();
+          P.push_back(*p);
+          P.back() /= norm;
+          AP.push_back(*q);
+          AP.back() /= norm;
+          if (P.size() == window)
+            compress(U, AU, theta, P, AP);
+
+          x.add(alpha, *p);
+          r->add(-alpha, *q);
+
+          res  = r->l2_norm();
+          conv = this->iteration_status(step, res, x);
+          if (conv != dealii::SolverControl::iterate)
+            break;
+
+          preconditioner.vmult(*z, *r);
+          const double rz_new = (*r) * (*z);
+          const double beta   = rz_new / rz;
+          rz                  = rz_new;
+
+          deflate(*z);
+          p->sadd(beta, 1., *z);
+        }
+    }
+
+  if (P.size() > 0)
+    compress(U, AU, theta, P, AP);
+  W.swap(U);
+  AW.swap(AU);
+  ritz_values.swap(theta);
+  last_operator = &A;
+
+  AssertThrow(conv == dealii::SolverControl::success,
+              dealii::SolverControl::NoConvergence(step, res));
+}
+
+
+template <typename VECTOR>
+void
+SolverDeflatedCG<VECTOR>::compress(std::vector<VECTOR> &U,
+                                   std::vector<VECTOR> &AU,
+                                   std::vector<double> &theta,
+                                   std::vector<VECTOR> &P,
+                                   std::vector<VECTOR> &AP) const
+{
+  // Rayleigh-Ritz on Z = [U, P]. Once the search directions lose their
+  // orthogonality, the columns of Z may be almost linearly dependent,
+  // and F = Z^T Z singular or numerically indefinite. Z is therefore
+  // first orthonormalized through the eigenvectors of F, dropping the
+  // negligible directions: with F V = V Lambda, the columns of
+  // Z V Lambda^{-1/2} are orthonormal, and the Ritz pairs are given by
+  // the symmetric eigenproblem of B^T G B, with B = V Lambda^{-1/2} and
+  // G = Z^T A Z.
+  std::vector<const VECTOR *> Z, AZ;
+  for (unsigned int i = 0; i < U.size(); ++i)
+    {
+      Z.push_back(&U[i]);
+      AZ.push_back(&AU[i]);
+    }
+  for (unsigned int i = 0; i < P.size(); ++i)
+    {
+      Z.push_back(&P[i]);
+      AZ.push_back(&AP[i]);
+    }
+
+  const unsigned int               n = Z.size();
+  dealii::FullMatrix<double>       G(n, n);
+  dealii::LAPACKFullMatrix<double> F(n, n);
+  double                           trace = 0;
+  for (unsigned int i = 0; i < n; ++i)
+    {
+      for (unsigned int j = i; j < n; ++j)
+        {
+          G(i, j) = G(j, i) = 0.5 * ((*Z[i]) * (*AZ[j]) + (*Z[j]) * (*AZ[i]));
+          F(i, j) = F(j, i) = (*Z[i]) * (*Z[j]);
+        }
+      trace += F(i, i);
+    }
+
+  // The eigenvalues of F are bounded by its trace.
+  dealii::Vector<double>     lambda;
+  dealii::FullMatrix<double> V;
+  F.compute_eigenvalues_symmetric(1e-10 * trace, trace, 0, lambda, V);
+
+  const unsigned int         m = lambda.size();
+  dealii::FullMatrix<double> B(n, m);
+  for (unsigned int i = 0; i < n; ++i)
+    for (unsigned int j = 0; j < m; ++j)
+      B(i, j) = V(i, j) / std::sqrt(lambda[j]);
+
+  dealii::FullMatrix<double> GB(n, m), reduced_G(m, m);
+  G.mmult(GB, B);
+  B.Tmmult(reduced_G, GB);
+
+  dealii::LAPACKFullMatrix<double> H(m, m);
+  double                           bound = 0;
+  for (unsigned int i = 0; i < m; ++i)
+    for (unsigned int j = i; j < m; ++j)
+      {
+        H(i, j) = H(j, i) = 0.5 * (reduced_G(i, j) + reduced_G(j, i));
+        bound += 2 * std::abs(H(i, j));
+      }
+
+  // The eigenvalues are returned in ascending order, and all of them lie
+  // in (-bound - 1, bound + 1].
+  dealii::Vector<double>     ritz;
+  dealii::FullMatrix<double> Y;
+  H.compute_eigenvalues_symmetric(-bound - 1, bound + 1, 0, ritz, Y);
+
+  dealii::FullMatrix<double> coefficients(n, ritz.size());
+  B.mmult(coefficients, Y);
+
+  const unsigned int  k = std::min<unsigned int>(subspace_dimension,
+                                                 ritz.size());
+  std::vector<VECTOR> new_U(k), new_AU(k);
+  theta.resize(k);
+  for (unsigned int i = 0; i < k; ++i)
+    {
+      new_U[i].reinit(*Z[0], false);
+      new_AU[i].reinit(*Z[0], false);
+      for (unsigned int j = 0; j < n; ++j)
+        {
+          new_U[i].add(coefficients(j, i), *Z[j]);
+          new_AU[i].add(coefficients(j, i), *AZ[j]);
+        }
+      const double norm = new_U[i].l2_norm();
+      new_U[i] /= norm;
+      new_AU[i] /= norm;
+      theta[i] = ritz[i];
+    }
+
+  U.swap(new_U);
+  AU.swap(new_AU);
+  P.clear();
+  AP.clear();
+}
+
+D2K_NAMESPACE_CLOSE
+
+
+#endif
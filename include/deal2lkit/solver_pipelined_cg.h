@@ -0,0 +1,191 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+#ifndef d2k_solver_pipelined_cg_h
+#define d2k_solver_pipelined_cg_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/logstream.h>
+
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/vector_memory.h>
+
+#include <deal2lkit/config.h>
+#include <deal2lkit/fused_dot_products.h>
+
+#include <cmath>
+#include <vector>
+
+
+
+D2K_NAMESPACE_OPEN
+
+/**
+ * Pipelined preconditioned conjugate gradients (Ghysels, Vanroose,
+ * Parallel Computing 40, 2014).
+ *
+ * The recurrences of the conjugate gradient method are rearranged so
+ * that the three scalar products of each iteration, (r,u), (w,u) and
+ * (r,r), are computed with a single global reduction. The reduction is
+ * started before the application of the preconditioner and of the
+ * operator, and is waited for only after them, so that its latency is
+ * hidden by the matrix-vector product (see FusedDotProducts). The
+ * reduction is non-blocking for LinearAlgebra::distributed::Vector and
+ * for the Trilinos vectors. For the other vector types the three scalar
+ * products are computed one after the other, and there is no gain over
+ * SolverCG.
+ *
+ * The price is the storage of nine vectors instead of four, three more
+ * vector updates per iteration, and a slightly larger accumulation of
+ * rounding errors. The convergence test uses the norm of the recursively
+ * updated residual.
+ */
+template <typename VECTOR>
+class SolverPipelinedCG : public dealii::Solver<VECTOR>
+{
+public:
+  /**
+   * Constructor.
+   */
+  SolverPipelinedCG(dealii::SolverControl &       cn,
+                    dealii::VectorMemory<VECTOR> &mem);
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default
+   * to allocate memory.
+   */
+  SolverPipelinedCG(dealii::SolverControl &cn);
+
+  /**
+   * Solve the linear system $Ax=b$ for x, starting from the content of
+   * x.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve(const MatrixType &        A,
+        VECTOR &                  x,
+        const VECTOR &            b,
+        const PreconditionerType &preconditioner);
+};
+
+// ============================================================
+// Explicit template functions
+// ============================================================
+
+template <typename VECTOR>
+SolverPipelinedCG<VECTOR>::SolverPipelinedCG(dealii::SolverControl &       cn,
+                                             dealii::VectorMemory<VECTOR> &mem)
+  : dealii::Solver<VECTOR>(cn, mem)
+{}
+
+
+template <typename VECTOR>
+SolverPipelinedCG<VECTOR>::SolverPipelinedCG(dealii::SolverControl &cn)
+  : dealii::Solver<VECTOR>(cn)
+{}
+
+
+template <typename VECTOR>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverPipelinedCG<VECTOR>::solve(const MatrixType &        A,
+                                 VECTOR &                  x,
+                                 const VECTOR &            b,
+                                 const PreconditionerType &preconditioner)
+{
+  dealii::LogStream::Prefix prefix("pipelined-cg");
+
+  // Same notation as in the paper: u = M r, w = A u, m = M w, n = A m,
+  // and p, s = A p, q = M s, z = A q.
+  std::vector<typename dealii::VectorMemory<VECTOR>::Pointer> vectors;
+  for (unsigned int i = 0; i < 9; ++i)
+    {
+      vectors.emplace_back(this->memory);
+      vectors.back()->reinit(x);
+    }
+  VECTOR &r = *vectors[0];
+  VECTOR &u = *vectors[1];
+  VECTOR &w = *vectors[2];
+  VECTOR &m = *vectors[3];
+  VECTOR &n = *vectors[4];
+  VECTOR &p = *vectors[5];
+  VECTOR &s = *vectors[6];
+  VECTOR &q = *vectors[7];
+  VECTOR &z = *vectors[8];
+
+  A.vmult(r, x);
+  r.sadd(-1., 1., b);
+  preconditioner.vmult(u, r);
+  A.vmult(w, u);
+
+  FusedDotProducts<VECTOR> dots;
+
+  unsigned int                 step      = 0;
+  double                       res       = 0;
+  double                       gamma_old = 0;
+  double                       alpha     = 0;
+  dealii::SolverControl::State conv      = dealii::SolverControl::iterate;
+  while (true)
+    {
+      dots.add(r, u);
+      dots.add(w, u);
+      dots.add(r, r);
+      dots.start();
+
+      preconditioner.vmult(m, w);
+      A.vmult(n, m);
+
+      const std::vector<double> values = dots.finish();
+      const double              gamma  = values[0];
+      const double              delta  = values[1];
+      res                              = std::sqrt(values[2]);
+
+      conv = this->iteration_status(step, res, x);
+      if (conv != dealii::SolverControl::iterate)
+        break;
+
+      double beta = 0;
+      if (step == 0)
+        alpha = gamma / delta;
+      else
+        {
+          beta  = gamma / gamma_old;
+          alpha = gamma / (delta - beta * gamma / alpha);
+        }
+      gamma_old = gamma;
+
+      z.sadd(beta, 1., n);
+      q.sadd(beta, 1., m);
+      s.sadd(beta, 1., w);
+      p.sadd(beta, 1., u);
+
+      x.add(alpha, p);
+      r.add(-alpha, s);
+      u.add(-alpha, q);
+      w.add(-alpha, z);
+
+      ++step;
+    }
+
+  AssertThrow(conv == dealii::SolverControl::success,
+              dealii::SolverControl::NoConvergence(step, res));
+}
+
+D2K_NAMESPACE_CLOSE
+
+
+#endif
@@ -0,0 +1,347 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+#ifndef d2k_solver_s_step_gmres_h
+#define d2k_solver_s_step_gmres_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/logstream.h>
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/vector_memory.h>
+
+#include <deal2lkit/config.h>
+#include <deal2lkit/fused_dot_products.h>
+
+#include <cmath>
+#include <vector>
+
+
+
+D2K_NAMESPACE_OPEN
+
+/**
+ * Communication avoiding, s-step GMRES, with right preconditioning.
+ *
+ * Every cycle generates the s+1 vectors of the monomial Krylov basis
+ * [r, AMr, ..., (AM)^s r] with s applications of the operator and of
+ * the preconditioner M. The basis is then orthonormalized by two passes
+ * of Cholesky QR. The Gram matrix of the first pass is reduced column
+ * by column with non-blocking reductions (see FusedDotProducts): the
+ * reduction of the column j runs while the preconditioner and the
+ * operator are applied to the basis vector j, and only the last column
+ * is waited for. The second pass computes all the scalar products with
+ * a single reduction. The Hessenberg matrix of the Arnoldi relation
+ * follows from the R factor, the small least squares problem is solved
+ * as in GMRES, and the method restarts from the new residual, which is
+ * a combination of the basis vectors. Its norm is the one of the
+ * residual of the least squares problem, so that the residual is
+ * computed explicitly only at the beginning, and after the basis
+ * collapsed to a single vector.
+ *
+ * Compared to GMRES restarted every s iterations, which waits for s+1
+ * reductions per cycle in the Gram-Schmidt process, this solver waits
+ * for two: the last column of the first Gram matrix, and the second
+ * Gram matrix. The monomial basis becomes ill conditioned quickly, so
+ * that s should be kept below ten. The vectors which are numerically dependent on the
+ * previous ones are dropped from the basis of the cycle. To limit the
+ * growth of the basis, each new vector is divided by an estimate of
+ * the norm of AM computed in the previous cycle.
+ */
+template <typename VECTOR>
+class SolverSStepGMRES : public dealii::Solver<VECTOR>
+{
+public:
+  /**
+   * Constructor. The method restarts every @p s_step_size iterations.
+   */
+  SolverSStepGMRES(dealii::SolverControl &       cn,
+                   dealii::VectorMemory<VECTOR> &mem,
+                   const unsigned int            s_step_size = 5);
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default
+   * to allocate memory.
+   */
+  SolverSStepGMRES(dealii::SolverControl &cn,
+                   const unsigned int     s_step_size = 5);
+
+  /**
+   * Solve the linear system $Ax=b$ for x, starting from the content of
+   * x.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve(const MatrixType &        A,
+        VECTOR &                  x,
+        const VECTOR &            b,
+        const PreconditionerType &preconditioner);
+
+private:
+  /**
+   * Orthonormalize in place the first k vectors of @p basis by Cholesky
+   * QR, where k is the size of their Gram matrix @p G, and update the
+   * upper triangular factor @p R, such that the original vectors are
+   * basis R. Return the number n of vectors which are numerically
+   * independent: only the first n vectors of the basis and the first n
+   * rows of R are kept.
+   */
+  unsigned int
+  cholesky_qr(std::vector<VECTOR> &             basis,
+              const dealii::FullMatrix<double> &G,
+              dealii::FullMatrix<double> &      R) const;
+
+  /**
+   * The Gram matrix of the first @p k vectors of @p basis, computed with
+   * a single reduction.
+   */
+  dealii::FullMatrix<double>
+  gram_matrix(const std::vector<VECTOR> &basis, const unsigned int k) const;
+
+  /**
+   * Number of iterations per cycle.
+   */
+  const unsigned int s_step_size;
+};
+
+// ============================================================
+// Explicit template functions
+// ============================================================
+
+template <typename VECTOR>
+SolverSStepGMRES<VECTOR>::SolverSStepGMRES(dealii::SolverControl &       cn,
+                                           dealii::VectorMemory<VECTOR> &mem,
+                                           const unsigned int s_step_size)
+  : dealii::Solver<VECTOR>(cn, mem)
+  , s_step_size(s_step_size)
+{}
+
+
+template <typename VECTOR>
+SolverSStepGMRES<VECTOR>::SolverSStepGMRES(dealii::SolverControl &cn,
+                                           const unsigned int     s_step_size)
+  : dealii::Solver<VECTOR>(cn)
+  , s_step_size(s_step_size)
+{}
+
+
+template <typename VECTOR>
+dealii::FullMatrix<double>
+SolverSStepGMRES<VECTOR>::gram_matrix(const std::vector<VECTOR> &basis,
+                                      const unsigned int         k) const
+{
+  FusedDotProducts<VECTOR> dots;
+  for (unsigned int i = 0; i < k; ++i)
+    for (unsigned int j = i; j < k; ++j)
+      dots.add(basis[i], basis[j]);
+  dots.start();
+  const std::vector<double> values = dots.finish();
+
+  dealii::FullMatrix<double> G(k, k);
+  for (unsigned int i = 0, c = 0; i < k; ++i)
+    for (unsigned int j = i; j < k; ++j, ++c)
+      G(i, j) = G(j, i) = values[c];
+  return G;
+}
+
+
+template <typename VECTOR>
+unsigned int
+SolverSStepGMRES<VECTOR>::cholesky_qr(std::vector<VECTOR> &             basis,
+                                      const dealii::FullMatrix<double> &G,
+                                      dealii::FullMatrix<double> &      R) const
+{
+  const unsigned int k = G.m();
+
+  // Upper triangular C with G = C^T C, stopping at the first column
+  // which is numerically dependent on the previous ones.
+  unsigned int               n = k;
+  dealii::FullMatrix<double> C(k, k);
+  for (unsigned int j = 0; j < k && n == k; ++j)
+    {
+      double d = G(j, j);
+      for (unsigned int l = 0; l < j; ++l)
+        d -= C(l, j) * C(l, j);
+      if (!(d > 1e-14 * G(j, j)))
+        {
+          n = j;
+          break;
+        }
+      C(j, j) = std::sqrt(d);
+      for (unsigned int i = j + 1; i < k; ++i)
+        {
+          double v = G(j, i);
+          for (unsigned int l = 0; l < j; ++l)
+            v -= C(l, j) * C(l, i);
+          C(j, i) = v / C(j, j);
+        }
+    }
+
+  // basis = basis C^{-1}, by columns.
+  for (unsigned int j = 0; j < n; ++j)
+    {
+      for (unsigned int i = 0; i < j; ++i)
+        basis[j].add(-C(i, j), basis[i]);
+      basis[j] /= C(j, j);
+    }
+
+  // R = C R, restricted to the first n rows. The rows of C above the
+  // dependent column are complete.
+  dealii::FullMatrix<double> new_R(n, R.n());
+  for (unsigned int i = 0; i < n; ++i)
+    for (unsigned int j = i; j < R.n(); ++j)
+      for (unsigned int l = i; l <= j && l < k; ++l)
+        new_R(i, j) += C(i, l) * R(l, j);
+  R = new_R;
+
+  return n;
+}
+
+
+template <typename VECTOR>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverSStepGMRES<VECTOR>::solve(const MatrixType &        A,
+                                VECTOR &                  x,
+                                const VECTOR &            b,
+                                const PreconditionerType &preconditioner)
+{
+  dealii::LogStream::Prefix prefix("s-step gmres");
+
+  const unsigned int  s = s_step_size;
+  std::vector<VECTOR> basis(s + 1);
+  for (auto &v : basis)
+    v.reinit(x, true);
+
+  typename dealii::VectorMemory<VECTOR>::Pointer r(this->memory);
+  typename dealii::VectorMemory<VECTOR>::Pointer tmp(this->memory);
+  r->reinit(x, true);
+  tmp->reinit(x, true);
+
+  // One set of scalar products per column of the first Gram matrix.
+  std::vector<FusedDotProducts<VECTOR>> columns(s + 1);
+
+  A.vmult(*r, x);
+  r->sadd(-1., 1., b);
+
+  unsigned int                 step  = 0;
+  double                       res   = r->l2_norm();
+  double                       scale = 1;
+  dealii::SolverControl::State conv  = dealii::SolverControl::iterate;
+  while (true)
+    {
+      conv = this->iteration_status(step, res, x);
+      if (conv != dealii::SolverControl::iterate)
+        break;
+
+      // Monomial basis, with AM basis[j] = scale basis[j+1]. The
+      // reduction of the column j of the Gram matrix runs while
+      // basis[j+1] is computed.
+      basis[0].equ(1. / res, *r);
+      for (unsigned int j = 0; j <= s; ++j)
+        {
+          for (unsigned int i = 0; i <= j; ++i)
+            columns[j].add(basis[i], basis[j]);
+          columns[j].start();
+
+          if (j < s)
+            {
+              preconditioner.vmult(*tmp, basis[j]);
+              A.vmult(basis[j + 1], *tmp);
+              basis[j + 1] /= scale;
+            }
+        }
+
+      dealii::FullMatrix<double> G(s + 1, s + 1);
+      for (unsigned int j = 0; j <= s; ++j)
+        {
+          const std::vector<double> values = columns[j].finish();
+          for (unsigned int i = 0; i <= j; ++i)
+            G(i, j) = G(j, i) = values[i];
+        }
+
+      dealii::FullMatrix<double> R(s + 1, s + 1);
+      for (unsigned int i = 0; i <= s; ++i)
+        R(i, i) = 1;
+      unsigned int k = cholesky_qr(basis, G, R);
+      k              = cholesky_qr(basis, gram_matrix(basis, k), R);
+
+      if (k == 1)
+        {
+          // The residual is an eigenvector of AM, with eigenvalue
+          // scale R(0,1) / R(0,0), up to the tolerance of cholesky_qr():
+          // compute the new residual explicitly.
+          const double lambda = scale * R(0, 1) / R(0, 0);
+          AssertThrow(lambda != 0,
+                      dealii::ExcMessage("Breakdown of the s-step basis."));
+          r->equ(res * R(0, 0) / lambda, basis[0]);
+          preconditioner.vmult(*tmp, *r);
+          x += *tmp;
+          ++step;
+
+          A.vmult(*r, x);
+          r->sadd(-1., 1., b);
+          res = r->l2_norm();
+          continue;
+        }
+      const unsigned int n = k - 1;
+
+      // AM Q R(0:n,0:n) = scale Q R(:,1:n+1), so that AM Q_n = Q H with
+      // H = scale R(:,1:n+1) R(0:n,0:n)^{-1}.
+      dealii::FullMatrix<double> R_n(n, n), R_n_inverse(n, n), H(k, n);
+      for (unsigned int i = 0; i < n; ++i)
+        for (unsigned int j = 0; j < n; ++j)
+          R_n(i, j) = R(i, j);
+      R_n_inverse.invert(R_n);
+      for (unsigned int i = 0; i < k; ++i)
+        for (unsigned int j = 0; j < n; ++j)
+          for (unsigned int l = 0; l < n; ++l)
+            H(i, j) += scale * R(i, l + 1) * R_n_inverse(l, j);
+
+      // Least squares problem with the residual res Q R(0,0) e_0. The
+      // new residual is Q c, with c = rhs - H y, and its norm is the one
+      // of c, since Q is orthonormal.
+      dealii::Vector<double> rhs(k), y(n), c(k);
+      rhs(0) = res * R(0, 0);
+      H.least_squares(y, rhs);
+      res = H.residual(c, y, rhs);
+
+      *r = 0;
+      for (unsigned int j = 0; j < n; ++j)
+        r->add(y(j), basis[j]);
+      preconditioner.vmult(*tmp, *r);
+      x += *tmp;
+
+      *r = 0;
+      for (unsigned int j = 0; j < k; ++j)
+        r->add(c(j), basis[j]);
+
+      // Growth factor of the monomial basis, used to scale the next one.
+      scale *= std::pow(std::abs(R(n, n) / R(0, 0)), 1. / n);
+      step += n;
+    }
+
+  AssertThrow(conv == dealii::SolverControl::success,
+              dealii::SolverControl::NoConvergence(step, res));
+}
+
+D2K_NAMESPACE_CLOSE
+
+
+#endif
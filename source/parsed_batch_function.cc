@@ -0,0 +1,979 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+#include <deal.II/base/numbers.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal2lkit/parsed_batch_function.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+
+using namespace dealii;
+
+D2K_NAMESPACE_OPEN
+
+const unsigned int BatchExpression::batch_size;
+
+
+/**
+ * A recursive descent parser, which emits the instructions of the
+ * expression in postfix order. The precedences are the ones of muParser:
+ * from the lowest, the ternary operator, ||, &&, the comparisons, + and
+ * -, * and / together with the unary minus, and ^, which is right
+ * associative.
+ */
+class BatchExpression::Compiler
+{
+public:
+  Compiler(const std::string &                  expression,
+           const std::vector<std::string> &     variables,
+           const std::map<std::string, double> &constants)
+    : expression(expression)
+    , variables(variables)
+    , constants(constants)
+  {}
+
+  /**
+   * Compile the expression. Return false if it is not supported.
+   */
+  bool
+  compile()
+  {
+    next_token();
+    if (!parse_ternary() || token != end)
+      return false;
+    return true;
+  }
+
+  std::vector<Instruction> program;
+  unsigned int             depth      = 0;
+  unsigned int             stack_size = 0;
+
+private:
+  enum Token
+  {
+    end,
+    number,
+    identifier,
+    symbol,
+    invalid
+  };
+
+  /**
+   * Read the next token of the expression into token and text.
+   */
+  void
+  next_token()
+  {
+    while (position < expression.size() &&
+           std::isspace(static_cast<unsigned char>(expression[position])))
+      ++position;
+
+    text.clear();
+    if (position == expression.size())
+      {
+        token = end;
+        return;
+      }
+
+    const char c = expression[position];
+    if (std::isdigit(static_cast<unsigned char>(c)) || c == '.')
+      {
+        const char *begin = expression.c_str() + position;
+        char *      after = nullptr;
+        value             = std::strtod(begin, &after);
+        if (after == begin)
+          token = invalid;
+        else
+          {
+            token = number;
+            position += after - begin;
+          }
+      }
+    else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_')
+      {
+        token = identifier;
+        for (; position < expression.size(); ++position)
+          {
+            const char d = expression[position];
+            if (!std::isalnum(static_cast<unsigned char>(d)) && d != '_')
+              break;
+            text += d;
+          }
+      }
+    else
+      {
+        token = symbol;
+        text  = c;
+        ++position;
+        if (position < expression.size())
+          {
+            const std::string pair = text + expression[position];
+            if (pair == "<=" || pair == ">=" || pair == "==" ||
+                pair == "!=" || pair == "&&" || pair == "||")
+              {
+                text = pair;
+                ++position;
+              }
+          }
+        if (text == "!" || text == "&" || text == "|" || text == "=")
+          token = invalid;
+      }
+  }
+
+  bool
+  accept(const std::string &s)
+  {
+    if (token == symbol && text == s)
+      {
+        next_token();
+        return true;
+      }
+    return false;
+  }
+
+  /**
+   * Append an instruction, folding it with its operands if they are all
+   * constants, and lowering the powers with a small integer exponent to
+   * integer_power.
+   */
+  void
+  emit(const Operation operation, const unsigned int variable = 0,
+       const double value = 0)
+  {
+    const unsigned int n = n_operands(operation);
+    if (operation != push_constant && operation != push_variable &&
+        program.size() >= n &&
+        std::all_of(program.end() - n,
+                    program.end(),
+                    [](const Instruction &i) {
+                      return i.operation == push_constant;
+                    }))
+      {
+        double operands[3];
+        for (unsigned int i = 0; i < n; ++i)
+          operands[i] = program[program.size() - n + i].value;
+        program.resize(program.size() - n);
+        program.push_back({push_constant, 0, apply(operation, operands)});
+        depth -= n - 1;
+        return;
+      }
+
+    if (operation == power && program.back().operation == push_constant &&
+        std::abs(program.back().value) <= max_integer_exponent &&
+        program.back().value == std::floor(program.back().value))
+      {
+        program.back().operation = integer_power;
+        --depth;
+        return;
+      }
+
+    program.push_back({operation, variable, value});
+    if (operation == push_constant || operation == push_variable)
+      ++depth;
+    else
+      depth -= n - 1;
+    stack_size = std::max(stack_size, depth);
+  }
+
+  bool
+  parse_ternary()
+  {
+    if (!parse_binary(0))
+      return false;
+    if (accept("?"))
+      {
+        if (!parse_ternary() || !accept(":") || !parse_ternary())
+          return false;
+        emit(select);
+      }
+    return true;
+  }
+
+  /**
+   * Binary operators, from the lowest precedence level.
+   */
+  bool
+  parse_binary(const unsigned int level)
+  {
+    static const std::vector<std::vector<std::pair<std::string, Operation>>>
+      levels = {{{"||", logical_or}},
+                {{"&&", logical_and}},
+                {{"<=", less_equal},
+                 {">=", greater_equal},
+                 {"==", equal},
+                 {"!=", not_equal},
+                 {"<", less},
+                 {">", greater}},
+                {{"+", add}, {"-", subtract}},
+                {{"*", multiply}, {"/", divide}}};
+
+    if (level == levels.size())
+      return parse_unary();
+
+    if (!parse_binary(level + 1))
+      return false;
+    for (bool found = true; found;)
+      {
+        found = false;
+        for (const auto &op : levels[level])
+          if (accept(op.first))
+            {
+              if (!parse_binary(level + 1))
+                return false;
+              emit(op.second);
+              found = true;
+              break;
+            }
+      }
+    return true;
+  }
+
+  bool
+  parse_unary()
+  {
+    if (accept("-"))
+      {
+        if (!parse_unary())
+          return false;
+        emit(negate);
+        return true;
+      }
+    if (accept("+"))
+      return parse_unary();
+    return parse_power();
+  }
+
+  bool
+  parse_power()
+  {
+    if (!parse_primary())
+      return false;
+    if (accept("^"))
+      {
+        if (!parse_unary_power())
+          return false;
+        emit(power);
+      }
+    return true;
+  }
+
+  /**
+   * The exponent of ^, which may have a sign, as in x^-2.
+   */
+  bool
+  parse_unary_power()
+  {
+    if (accept("-"))
+      {
+        if (!parse_unary_power())
+          return false;
+        emit(negate);
+        return true;
+      }
+    if (accept("+"))
+      return parse_unary_power();
+    return parse_power();
+  }
+
+  bool
+  parse_primary()
+  {
+    if (token == number)
+      {
+        emit(push_constant, 0, value);
+        next_token();
+        return true;
+      }
+
+    if (accept("("))
+      return parse_ternary() && accept(")");
+
+    if (token != identifier)
+      return false;
+
+    const std::string name = text;
+    next_token();
+
+    if (!accept("("))
+      {
+        const auto v = std::find(variables.begin(), variables.end(), name);
+        if (v != variables.end())
+          emit(push_variable, v - variables.begin());
+        else if (constants.find(name) != constants.end())
+          emit(push_constant, 0, constants.at(name));
+        else if (name == "_pi")
+          emit(push_constant, 0, numbers::PI);
+        else if (name == "_e")
+          emit(push_constant, 0, numbers::E);
+        else
+          return false;
+        return true;
+      }
+
+    unsigned int n_arguments = 0;
+    if (!accept(")"))
+      {
+        do
+          {
+            if (!parse_ternary())
+              return false;
+            ++n_arguments;
+          }
+        while (accept(","));
+        if (!accept(")"))
+          return false;
+      }
+
+    static const std::map<std::string, Operation> functions = {
+      {"sin", sin},     {"cos", cos},     {"tan", tan},     {"asin", asin},
+      {"acos", acos},   {"atan", atan},   {"sinh", sinh},   {"cosh", cosh},
+      {"tanh", tanh},   {"asinh", asinh}, {"acosh", acosh}, {"atanh", atanh},
+      {"exp", exp},     {"log", log},     {"ln", log},      {"log2", log2},
+      {"log10", log10}, {"sqrt", sqrt},   {"abs", abs},     {"sign", sign},
+      {"rint", rint},   {"floor", floor}, {"ceil", ceil},   {"cot", cot},
+      {"sec", sec},     {"csc", csc},     {"erfc", erfc}};
+
+    if (functions.find(name) != functions.end() && n_arguments == 1)
+      emit(functions.at(name));
+    else if (name == "pow" && n_arguments == 2)
+      emit(power);
+    else if (name == "if" && n_arguments == 3)
+      emit(select);
+    else if ((name == "min" || name == "max") && n_arguments > 0)
+      for (unsigned int i = 1; i < n_arguments; ++i)
+        emit(name == "min" ? minimum : maximum);
+    else
+      return false;
+    return true;
+  }
+
+  /**
+   * Largest absolute value of the exponents lowered to integer_power.
+   */
+  static constexpr double max_integer_exponent = 64;
+
+  const std::string &                  expression;
+  const std::vector<std::string> &     variables;
+  const std::map<std::string, double> &constants;
+
+  std::size_t position = 0;
+  Token       token    = end;
+  std::string text;
+  double      value = 0;
+};
+
+
+unsigned int
+BatchExpression::n_operands(const Operation operation)
+{
+  switch (operation)
+    {
+      case push_constant:
+      case push_variable:
+        return 0;
+      case add:
+      case subtract:
+      case multiply:
+      case divide:
+      case power:
+      case less:
+      case greater:
+      case less_equal:
+      case greater_equal:
+      case equal:
+      case not_equal:
+      case logical_and:
+      case logical_or:
+      case minimum:
+      case maximum:
+        return 2;
+      case select:
+        return 3;
+      default:
+        return 1;
+    }
+}
+
+
+double
+BatchExpression::apply(const Operation operation, const double *x)
+{
+  switch (operation)
+    {
+      case add:
+        return x[0] + x[1];
+      case subtract:
+        return x[0] - x[1];
+      case multiply:
+        return x[0] * x[1];
+      case divide:
+        return x[0] / x[1];
+      case power:
+        return std::pow(x[0], x[1]);
+      case negate:
+        return -x[0];
+      case less:
+        return x[0] < x[1];
+      case greater:
+        return x[0] > x[1];
+      case less_equal:
+        return x[0] <= x[1];
+      case greater_equal:
+        return x[0] >= x[1];
+      case equal:
+        return x[0] == x[1];
+      case not_equal:
+        return x[0] != x[1];
+      case logical_and:
+        return x[0] != 0 && x[1] != 0;
+      case logical_or:
+        return x[0] != 0 || x[1] != 0;
+      case select:
+        return x[0] != 0 ? x[1] : x[2];
+      case minimum:
+        return std::min(x[0], x[1]);
+      case maximum:
+        return std::max(x[0], x[1]);
+      case sin:
+        return std::sin(x[0]);
+      case cos:
+        return std::cos(x[0]);
+      case tan:
+        return std::tan(x[0]);
+      case asin:
+        return std::asin(x[0]);
+      case acos:
+        return std::acos(x[0]);
+      case atan:
+        return std::atan(x[0]);
+      case sinh:
+        return std::sinh(x[0]);
+      case cosh:
+        return std::cosh(x[0]);
+      case tanh:
+        return std::tanh(x[0]);
+      case asinh:
+        return std::asinh(x[0]);
+      case acosh:
+        return std::acosh(x[0]);
+      case atanh:
+        return std::atanh(x[0]);
+      case exp:
+        return std::exp(x[0]);
+      case log:
+        return std::log(x[0]);
+      case log2:
+        return std::log2(x[0]);
+      case log10:
+        return std::log10(x[0]);
+      case sqrt:
+        return std::sqrt(x[0]);
+      case abs:
+        return std::abs(x[0]);
+      case sign:
+        return (x[0] > 0) - (x[0] < 0);
+      case rint:
+        return std::floor(x[0] + 0.5);
+      case floor:
+        return std::floor(x[0]);
+      case ceil:
+        return std::ceil(x[0]);
+      case cot:
+        return 1. / std::tan(x[0]);
+      case sec:
+        return 1. / std::cos(x[0]);
+      case csc:
+        return 1. / std::sin(x[0]);
+      case erfc:
+        return std::erfc(x[0]);
+      default:
+        Assert(false, ExcInternalError());
+        return 0;
+    }
+}
+
+
+namespace
+{
+  /**
+   * Replace each of the first @p n values of @p a with f(a).
+   */
+  template <typename Function>
+  inline void
+  transform(const unsigned int n, double *a, const Function &f)
+  {
+    DEAL_II_OPENMP_SIMD_PRAGMA
+    for (unsigned int i = 0; i < n; ++i)
+      a[i] = f(a[i]);
+  }
+
+  /**
+   * Replace each of the first @p n values of @p a with f(a, b).
+   */
+  template <typename Function>
+  inline void
+  transform(const unsigned int n,
+            double *           a,
+            const double *     b,
+            const Function &   f)
+  {
+    DEAL_II_OPENMP_SIMD_PRAGMA
+    for (unsigned int i = 0; i < n; ++i)
+      a[i] = f(a[i], b[i]);
+  }
+
+  /**
+   * Raise the first @p n values of @p a to the power @p exponent by
+   * repeated squaring, using @p scratch for the partial products.
+   */
+  void
+  raise_to_integer_power(const unsigned int n,
+                         double *           a,
+                         double *           scratch,
+                         const int          exponent)
+  {
+    bool first = true;
+    for (unsigned int e = std::abs(exponent); e > 0;)
+      {
+        if (e % 2 == 1)
+          {
+            if (first)
+              std::copy(a, a + n, scratch);
+            else
+              transform(n, scratch, a, [](const double x, const double y) {
+                return x * y;
+              });
+            first = false;
+          }
+        e /= 2;
+        if (e > 0)
+          transform(n, a, [](const double x) { return x * x; });
+      }
+
+    if (first)
+      std::fill(a, a + n, 1.);
+    else if (exponent < 0)
+      transform(n, a, scratch, [](const double, const double y) {
+        return 1. / y;
+      });
+    else
+      std::copy(scratch, scratch + n, a);
+  }
+} // namespace
+
+
+bool
+BatchExpression::initialize(const std::string &                  expression,
+                            const std::vector<std::string> &     variables,
+                            const std::map<std::string, double> &constants)
+{
+  Compiler compiler(expression, variables, constants);
+  if (compiler.compile())
+    {
+      program    = compiler.program;
+      stack_size = std::max(compiler.stack_size, 1u);
+      return true;
+    }
+  program.clear();
+  stack_size = 0;
+  return false;
+}
+
+
+bool
+BatchExpression::is_initialized() const
+{
+  return program.size() > 0;
+}
+
+
+void
+BatchExpression::evaluate(const std::vector<const double *> &variables,
+                          const unsigned int                 n_points,
+                          double *                           result) const
+{
+  Assert(is_initialized(), ExcNotInitialized());
+
+  // The stack holds one batch per entry.
+  std::vector<double> stack(stack_size * batch_size);
+
+  for (unsigned int begin = 0; begin < n_points; begin += batch_size)
+    {
+      const unsigned int n     = std::min(batch_size, n_points - begin);
+      unsigned int       depth = 0;
+
+      for (const auto &instruction : program)
+        {
+          // The operands are the topmost n_op entries, and the result
+          // replaces the first one. A push writes the entry above the
+          // top.
+          const unsigned int n_op = n_operands(instruction.operation);
+          Assert(depth >= n_op, ExcInternalError());
+          double *      a = stack.data() + (depth - n_op) * batch_size;
+          const double *b = (n_op > 1 ? a + batch_size : a);
+          const double *c = (n_op > 2 ? a + 2 * batch_size : a);
+
+          switch (instruction.operation)
+            {
+              case push_constant:
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int i = 0; i < n; ++i)
+                  a[i] = instruction.value;
+                break;
+              case push_variable:
+                std::copy(variables[instruction.variable] + begin,
+                          variables[instruction.variable] + begin + n,
+                          a);
+                break;
+              case add:
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int i = 0; i < n; ++i)
+                  a[i] += b[i];
+                break;
+              case subtract:
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int i = 0; i < n; ++i)
+                  a[i] -= b[i];
+                break;
+              case multiply:
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int i = 0; i < n; ++i)
+                  a[i] *= b[i];
+                break;
+              case divide:
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int i = 0; i < n; ++i)
+                  a[i] /= b[i];
+                break;
+              case power:
+                transform(n, a, b, [](const double x, const double y) {
+                  return std::pow(x, y);
+                });
+                break;
+              case integer_power:
+                {
+                  double scratch[batch_size];
+                  raise_to_integer_power(n,
+                                         a,
+                                         scratch,
+                                         static_cast<int>(instruction.value));
+                }
+                break;
+              case negate:
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int i = 0; i < n; ++i)
+                  a[i] = -a[i];
+                break;
+              case less:
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int i = 0; i < n; ++i)
+                  a[i] = (a[i] < b[i] ? 1. : 0.);
+                break;
+              case greater:
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int i = 0; i < n; ++i)
+                  a[i] = (a[i] > b[i] ? 1. : 0.);
+                break;
+              case less_equal:
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int i = 0; i < n; ++i)
+                  a[i] = (a[i] <= b[i] ? 1. : 0.);
+                break;
+              case greater_equal:
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int i = 0; i < n; ++i)
+                  a[i] = (a[i] >= b[i] ? 1. : 0.);
+                break;
+              case equal:
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int i = 0; i < n; ++i)
+                  a[i] = (a[i] == b[i] ? 1. : 0.);
+                break;
+              case not_equal:
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int i = 0; i < n; ++i)
+                  a[i] = (a[i] != b[i] ? 1. : 0.);
+                break;
+              case logical_and:
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int i = 0; i < n; ++i)
+                  a[i] = (a[i] != 0 && b[i] != 0 ? 1. : 0.);
+                break;
+              case logical_or:
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int i = 0; i < n; ++i)
+                  a[i] = (a[i] != 0 || b[i] != 0 ? 1. : 0.);
+                break;
+              case select:
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int i = 0; i < n; ++i)
+                  a[i] = (a[i] != 0 ? b[i] : c[i]);
+                break;
+              case minimum:
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int i = 0; i < n; ++i)
+                  a[i] = std::min(a[i], b[i]);
+                break;
+              case maximum:
+                DEAL_II_OPENMP_SIMD_PRAGMA
+                for (unsigned int i = 0; i < n; ++i)
+                  a[i] = std::max(a[i], b[i]);
+                break;
+              case sin:
+                transform(n, a, [](const double x) { return std::sin(x); });
+                break;
+              case cos:
+                transform(n, a, [](const double x) { return std::cos(x); });
+                break;
+              case tan:
+                transform(n, a, [](const double x) { return std::tan(x); });
+                break;
+              case asin:
+                transform(n, a, [](const double x) { return std::asin(x); });
+                break;
+              case acos:
+                transform(n, a, [](const double x) { return std::acos(x); });
+                break;
+              case atan:
+                transform(n, a, [](const double x) { return std::atan(x); });
+                break;
+              case sinh:
+                transform(n, a, [](const double x) { return std::sinh(x); });
+                break;
+              case cosh:
+                transform(n, a, [](const double x) { return std::cosh(x); });
+                break;
+              case tanh:
+                transform(n, a, [](const double x) { return std::tanh(x); });
+                break;
+              case asinh:
+                transform(n, a, [](const double x) { return std::asinh(x); });
+                break;
+              case acosh:
+                transform(n, a, [](const double x) { return std::acosh(x); });
+                break;
+              case atanh:
+                transform(n, a, [](const double x) { return std::atanh(x); });
+                break;
+              case exp:
+                transform(n, a, [](const double x) { return std::exp(x); });
+                break;
+              case log:
+                transform(n, a, [](const double x) { return std::log(x); });
+                break;
+              case log2:
+                transform(n, a, [](const double x) { return std::log2(x); });
+                break;
+              case log10:
+                transform(n, a, [](const double x) { return std::log10(x); });
+                break;
+              case sqrt:
+                transform(n, a, [](const double x) { return std::sqrt(x); });
+                break;
+              case abs:
+                transform(n, a, [](const double x) { return std::abs(x); });
+                break;
+              case sign:
+                transform(n, a, [](const double x) {
+                  return (x > 0) - (x < 0);
+                });
+                break;
+              case rint:
+                transform(n, a, [](const double x) {
+                  return std::floor(x + 0.5);
+                });
+                break;
+              case floor:
+                transform(n, a, [](const double x) { return std::floor(x); });
+                break;
+              case ceil:
+                transform(n, a, [](const double x) { return std::ceil(x); });
+                break;
+              case cot:
+                transform(n, a, [](const double x) {
+                  return 1. / std::tan(x);
+                });
+                break;
+              case sec:
+                transform(n, a, [](const double x) {
+                  return 1. / std::cos(x);
+                });
+                break;
+              case csc:
+                transform(n, a, [](const double x) {
+                  return 1. / std::sin(x);
+                });
+                break;
+              case erfc:
+                transform(n, a, [](const double x) { return std::erfc(x); });
+                break;
+              default:
+                Assert(false, ExcInternalError());
+            }
+
+          depth = depth + 1 - n_op;
+        }
+
+      Assert(depth == 1, ExcInternalError());
+      std::copy(stack.data(), stack.data() + n, result + begin);
+    }
+}
+
+
+template <int spacedim>
+ParsedBatchFunction<spacedim>::ParsedBatchFunction(
+  const unsigned int n_components,
+  const double       h)
+  : Functions::ParsedFunction<spacedim>(n_components, h)
+{}
+
+
+template <int spacedim>
+void
+ParsedBatchFunction<spacedim>::parse_parameters(ParameterHandler &prm)
+{
+  Functions::ParsedFunction<spacedim>::parse_parameters(prm);
+
+  // Same interpretation of the parameters as in
+  // Functions::ParsedFunction::parse_parameters().
+  const std::vector<std::string> variables =
+    Utilities::split_string_list(prm.get("Variable names"), ',');
+  const std::vector<std::string> expressions =
+    Utilities::split_string_list(prm.get("Function expression"), ';');
+
+  std::map<std::string, double> constants;
+  for (const auto &constant :
+       Utilities::split_string_list(prm.get("Function constants"), ','))
+    {
+      const std::vector<std::string> name_value =
+        Utilities::split_string_list(constant, '=');
+      if (name_value.size() == 2)
+        constants[name_value[0]] = Utilities::string_to_double(name_value[1]);
+    }
+  constants["pi"] = numbers::PI;
+  constants["Pi"] = numbers::PI;
+
+  time_dependent = (variables.size() == spacedim + 1);
+
+  this->expressions.clear();
+  if (expressions.size() != this->n_components ||
+      (variables.size() != spacedim && !time_dependent))
+    return;
+
+  this->expressions.resize(this->n_components);
+  for (unsigned int c = 0; c < this->n_components; ++c)
+    if (!this->expressions[c].initialize(expressions[c], variables, constants))
+      {
+        this->expressions.clear();
+        return;
+      }
+}
+
+
+template <int spacedim>
+bool
+ParsedBatchFunction<spacedim>::is_batched() const
+{
+  return expressions.size() > 0;
+}
+
+
+template <int spacedim>
+void
+ParsedBatchFunction<spacedim>::fill_variables(
+  const std::vector<Point<spacedim>> &points,
+  std::vector<std::vector<double>> &  variables) const
+{
+  variables.resize(spacedim + (time_dependent ? 1 : 0));
+  for (unsigned int d = 0; d < spacedim; ++d)
+    {
+      variables[d].resize(points.size());
+      for (unsigned int q = 0; q < points.size(); ++q)
+        variables[d][q] = points[q][d];
+    }
+  if (time_dependent)
+    variables[spacedim].assign(points.size(), this->get_time());
+}
+
+
+template <int spacedim>
+void
+ParsedBatchFunction<spacedim>::value_list(
+  const std::vector<Point<spacedim>> &points,
+  std::vector<double> &               values,
+  const unsigned int                  component) const
+{
+  if (!is_batched())
+    {
+      Functions::ParsedFunction<spacedim>::value_list(points,
+                                                      values,
+                                                      component);
+      return;
+    }
+
+  AssertDimension(values.size(), points.size());
+  AssertIndexRange(component, this->n_components);
+
+  std::vector<std::vector<double>> variables;
+  fill_variables(points, variables);
+  std::vector<const double *> pointers;
+  for (const auto &v : variables)
+    pointers.push_back(v.data());
+
+  expressions[component].evaluate(pointers, points.size(), values.data());
+}
+
+
+template <int spacedim>
+void
+ParsedBatchFunction<spacedim>::vector_value_list(
+  const std::vector<Point<spacedim>> &points,
+  std::vector<Vector<double>> &       values) const
+{
+  if (!is_batched())
+    {
+      Functions::ParsedFunction<spacedim>::vector_value_list(points, values);
+      return;
+    }
+
+  AssertDimension(values.size(), points.size());
+
+  std::vector<std::vector<double>> variables;
+  fill_variables(points, variables);
+  std::vector<const double *> pointers;
+  for (const auto &v : variables)
+    pointers.push_back(v.data());
+
+  std::vector<double> component_values(points.size());
+  for (unsigned int c = 0; c < this->n_components; ++c)
+    {
+      expressions[c].evaluate(pointers,
+                              points.size(),
+                              component_values.data());
+      for (unsigned int q = 0; q < points.size(); ++q)
+        values[q](c) = component_values[q];
+    }
+}
+
+
+template class ParsedBatchFunction<1>;
+template class ParsedBatchFunction<2>;
+template class ParsedBatchFunction<3>;
+
+D2K_NAMESPACE_CLOSE
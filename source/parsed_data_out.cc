@@ -15,6 +15,7 @@
 
 #include <deal.II/base/logstream.h>
 #include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/table.h>
 #include <deal.II/base/utilities.h>
 
 #include <deal.II/grid/grid_tools.h>
@@ -32,14 +33,196 @@ DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
 
 #include <deal.II/numerics/data_out.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 using namespace dealii;
 
+namespace
+{
+#ifdef DEAL_II_WITH_MPI
+  /**
+   * Free @p comm, unless MPI has already been finalized, which happens
+   * when a ParsedDataOut outlives the MPI_InitFinalize object.
+   */
+  void
+  free_communicator(MPI_Comm &comm)
+  {
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (!finalized)
+      MPI_Comm_free(&comm);
+  }
+#endif
+
+  /**
+   * A copy of the patches built by a DataOut object. It can be written
+   * independently of the DoFHandler and of the data vectors that were
+   * used to build it, and therefore also from a different thread.
+   */
+  template <int dim, int spacedim>
+  class PatchesSnapshot : public DataOutInterface<dim, spacedim>
+  {
+  public:
+    using NonscalarDataRanges = std::vector<
+      std::tuple<unsigned int,
+                 unsigned int,
+                 std::string,
+                 DataComponentInterpretation::DataComponentInterpretation>>;
+
+    PatchesSnapshot(std::vector<DataOutBase::Patch<dim, spacedim>> &&patches,
+                    const std::vector<std::string> &    dataset_names,
+                    const NonscalarDataRanges &         nonscalar_data_ranges,
+                    const DataOutBase::OutputFormat     format)
+      : patches(std::move(patches))
+      , dataset_names(dataset_names)
+      , nonscalar_data_ranges(nonscalar_data_ranges)
+    {
+      this->set_default_format(format);
+    }
+
+  protected:
+    virtual const std::vector<DataOutBase::Patch<dim, spacedim>> &
+    get_patches() const override
+    {
+      return patches;
+    }
+
+    virtual std::vector<std::string>
+    get_dataset_names() const override
+    {
+      return dataset_names;
+    }
+
+    virtual NonscalarDataRanges
+    get_nonscalar_data_ranges() const override
+    {
+      return nonscalar_data_ranges;
+    }
+
+  private:
+    const std::vector<DataOutBase::Patch<dim, spacedim>> patches;
+    const std::vector<std::string>                       dataset_names;
+    const NonscalarDataRanges                            nonscalar_data_ranges;
+  };
+
+
+  /**
+   * Return a copy of the geometry of the given patches: their vertices
+   * and, if they are available, the rows of the data table containing
+   * the positions of their points.
+   */
+  template <int dim, int spacedim>
+  std::vector<DataOutBase::Patch<dim, spacedim>>
+  extract_geometry(
+    const std::vector<DataOutBase::Patch<dim, spacedim>> &patches)
+  {
+    std::vector<DataOutBase::Patch<dim, spacedim>> geometry(patches.size());
+    for (unsigned int i = 0; i < patches.size(); ++i)
+      {
+        geometry[i].vertices             = patches[i].vertices;
+        geometry[i].n_subdivisions       = patches[i].n_subdivisions;
+        geometry[i].points_are_available = patches[i].points_are_available;
+
+        if (patches[i].points_are_available)
+          {
+            const unsigned int n_rows   = patches[i].data.n_rows();
+            const unsigned int n_points = patches[i].data.n_cols();
+            geometry[i].data.reinit(TableIndices<2>(spacedim, n_points));
+            for (unsigned int d = 0; d < spacedim; ++d)
+              for (unsigned int q = 0; q < n_points; ++q)
+                geometry[i].data(d, q) =
+                  patches[i].data(n_rows - spacedim + d, q);
+          }
+      }
+    return geometry;
+  }
+
+
+  /**
+   * Replace the geometry of the given patches with the one returned by
+   * extract_geometry(). Return false, without touching the patches, if
+   * the two are not compatible.
+   */
+  template <int dim, int spacedim>
+  bool
+  restore_geometry(
+    std::vector<DataOutBase::Patch<dim, spacedim>> &      patches,
+    const std::vector<DataOutBase::Patch<dim, spacedim>> &geometry)
+  {
+    if (patches.size() != geometry.size())
+      return false;
+    for (unsigned int i = 0; i < patches.size(); ++i)
+      if (patches[i].n_subdivisions != geometry[i].n_subdivisions)
+        return false;
+
+    for (unsigned int i = 0; i < patches.size(); ++i)
+      {
+        patches[i].vertices = geometry[i].vertices;
+
+        if (geometry[i].points_are_available)
+          {
+            const unsigned int n_data =
+              patches[i].data.n_rows() -
+              (patches[i].points_are_available ? spacedim : 0);
+            const unsigned int n_points = patches[i].data.n_cols();
+
+            Table<2, float> data(n_data + spacedim, n_points);
+            for (unsigned int r = 0; r < n_data; ++r)
+              for (unsigned int q = 0; q < n_points; ++q)
+                data(r, q) = patches[i].data(r, q);
+            for (unsigned int d = 0; d < spacedim; ++d)
+              for (unsigned int q = 0; q < n_points; ++q)
+                data(n_data + d, q) = geometry[i].data(d, q);
+
+            patches[i].data.swap(data);
+            patches[i].points_are_available = true;
+          }
+      }
+    return true;
+  }
+
+
+  /**
+   * A DataOut object that can hand over its patches to a
+   * PatchesSnapshot.
+   */
+  template <int dim, int spacedim>
+  class SnapshotDataOut : public DataOut<dim, spacedim>
+  {
+  public:
+    /**
+     * Move the patches built by build_patches() into a new snapshot.
+     * After calling this function, this object cannot be written
+     * anymore.
+     */
+    std::shared_ptr<PatchesSnapshot<dim, spacedim>>
+    snapshot(const DataOutBase::OutputFormat format)
+    {
+      return std::make_shared<PatchesSnapshot<dim, spacedim>>(
+        std::move(this->patches),
+        this->get_dataset_names(),
+        this->get_nonscalar_data_ranges(),
+        format);
+    }
+
+    /**
+     * Read-write access to the patches built by build_patches().
+     */
+    std::vector<DataOutBase::Patch<dim, spacedim>> &
+    get_patches_for_cache()
+    {
+      return this->patches;
+    }
+  };
+} // namespace
+
 D2K_NAMESPACE_OPEN
 
 template <int dim, int spacedim>
@@ -60,10 +243,65 @@ ParsedDataOut<dim, spacedim>::ParsedDataOut(
   , base_name(base_name_input)
   , incremental_run_prefix(incremental_run_prefix)
   , files_to_save(files_to_save)
+  , n_output_files(0)
+  , n_output_groups(0)
+  , output_group(0)
+  , group_comm(MPI_COMM_SELF)
+  , mesh_changed(true)
+  , output_triangulation(nullptr)
+  , hdf5_mapping(nullptr)
+  , n_hdf5_meshes(0)
+  , output_time(0)
+  , output_time_set(false)
+  , cache_patches(false)
+  , has_postprocessed_data(false)
+  , cached_mapping(nullptr)
+  , cached_subdivisions(0)
+  , asynchronous_output(false)
+  , max_pending_outputs(2)
+  , writing_output(false)
+  , stop_writer(false)
 {
   initialized = false;
 }
 
+
+template <int dim, int spacedim>
+ParsedDataOut<dim, spacedim>::~ParsedDataOut()
+{
+  // A destructor must not throw: report the errors of the outputs which
+  // were never waited for, instead of losing them.
+  try
+    {
+      wait_for_pending_output();
+    }
+  catch (std::exception &exc)
+    {
+      std::cerr << "ParsedDataOut: an asynchronous output failed: "
+                << exc.what() << std::endl;
+    }
+  catch (...)
+    {
+      std::cerr << "ParsedDataOut: an asynchronous output failed."
+                << std::endl;
+    }
+
+  {
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    stop_writer = true;
+  }
+  writer_condition.notify_all();
+  if (writer_thread.joinable())
+    writer_thread.join();
+
+  tria_connection.disconnect();
+
+#ifdef DEAL_II_WITH_MPI
+  if (n_output_groups > 0)
+    free_communicator(group_comm);
+#endif
+}
+
 template <int dim, int spacedim>
 void
 ParsedDataOut<dim, spacedim>::declare_parameters(ParameterHandler &prm)
@@ -108,6 +346,55 @@ ParsedDataOut<dim, spacedim>::declare_parameters(ParameterHandler &prm)
                 "Subdivisions",
                 std::to_string(subdivisions),
                 Patterns::Integer(0));
+
+  add_parameter(prm,
+                &cache_patches,
+                "Cache patch geometry",
+                "false",
+                Patterns::Bool(),
+                "If true, the position of the points of the patches is "
+                "computed only when the triangulation, the mapping or the "
+                "number of subdivisions change, and reused by the following "
+                "outputs, where only the data is evaluated. This is correct "
+                "only when the output data does not depend on the mapping, "
+                "as for Lagrange elements. The cache is never used for "
+                "outputs containing DataPostprocessor objects. When the "
+                "mapping moves the mesh, as a MappingQEulerian does, call "
+                "invalidate_geometry() after each change of the "
+                "displacement.");
+
+  add_parameter(prm,
+                &n_output_files,
+                "Number of output files",
+                "0",
+                Patterns::Integer(0),
+                "Number of vtu files written at each output when running "
+                "with more than one process. The processes are split into "
+                "this number of groups, and each group writes a single file "
+                "with collective MPI-IO calls, together with a pvtu record. "
+                "If zero, every process writes its own file.");
+
+  add_parameter(prm,
+                &asynchronous_output,
+                "Asynchronous output",
+                "false",
+                Patterns::Bool(),
+                "If true, the patches are built by the calling thread, and "
+                "written to disk by a background thread, so that "
+                "write_data_and_clear() returns immediately. This only "
+                "applies when every process writes its own file: the hdf5 "
+                "output and the grouped output (Number of output files "
+                "larger than zero) use collective MPI calls, and are "
+                "always written synchronously.");
+
+  add_parameter(prm,
+                &max_pending_outputs,
+                "Maximum number of pending outputs",
+                "2",
+                Patterns::Integer(1),
+                "Maximum number of outputs queued or being written in "
+                "asynchronous mode. When this number is reached, "
+                "write_data_and_clear() waits for the writer thread.");
 }
 
 template <int dim, int spacedim>
@@ -134,6 +421,56 @@ ParsedDataOut<dim, spacedim>::parse_parameters_call_back()
     {
       path_solution_dir = "./";
     }
+
+#ifdef DEAL_II_WITH_MPI
+  if (n_output_groups > 0)
+    free_communicator(group_comm);
+#endif
+
+  n_output_groups = (n_output_files < n_mpi_processes ? n_output_files : 0);
+  output_group = 0;
+  group_comm   = MPI_COMM_SELF;
+
+#ifdef DEAL_II_WITH_MPI
+  if (n_output_groups > 0)
+    {
+      // Contiguous ranks end up in the same group.
+      output_group = this_mpi_process * n_output_groups / n_mpi_processes;
+      MPI_Comm_split(comm, output_group, this_mpi_process, &group_comm);
+    }
+#endif
+
+  // grouped_output() needs the DataOut object, which is not built yet.
+  const bool grouped = (n_output_groups > 0 && output_format == "vtu");
+  if (asynchronous_output && (grouped || output_format == "hdf5") &&
+      this_mpi_process == 0)
+    std::cerr << "ParsedDataOut: the asynchronous output is not available "
+              << "for the " << (grouped ? "grouped" : "hdf5")
+              << " output, which is written synchronously." << std::endl;
+}
+
+
+
+template <int dim, int spacedim>
+bool
+ParsedDataOut<dim, spacedim>::grouped_output() const
+{
+  return (n_output_groups > 0 && data_out &&
+          data_out->default_suffix() == ".vtu");
+}
+
+
+
+template <int dim, int spacedim>
+std::string
+ParsedDataOut<dim, spacedim>::output_file_name(
+  const unsigned int index,
+  const unsigned int n_files) const
+{
+  const unsigned int digits = std::max(2u, Utilities::needed_digits(n_files));
+  return current_name + "." + Utilities::int_to_string(index, digits) + "." +
+         Utilities::int_to_string(n_files, digits) +
+         data_out->default_suffix();
 }
 
 template <int dim, int spacedim>
@@ -143,7 +480,7 @@ ParsedDataOut<dim, spacedim>::prepare_data_output(
   const std::string &              suffix)
 {
   deallog.push("PrepareOutput");
-  data_out = std::make_shared<DataOut<dim, spacedim>>();
+  data_out = std::make_shared<SnapshotDataOut<dim, spacedim>>();
   data_out->set_default_format(DataOutBase::parse_output_format(output_format));
 
   current_name = path_solution_dir + base_name + suffix;
@@ -154,11 +491,17 @@ ParsedDataOut<dim, spacedim>::prepare_data_output(
     {
       // If the output is needed and we have many processes, just output
       // the one we need *in intermediate format*.
-      if (n_mpi_processes > 1)
+      if (output_format == "hdf5")
+        {
+          fname += data_out->default_suffix();
+        }
+      else if (grouped_output())
         {
-          fname += ("." + Utilities::int_to_string(this_mpi_process, 2) + "." +
-                    Utilities::int_to_string(n_mpi_processes, 2) +
-                    data_out->default_suffix());
+          fname = output_file_name(output_group, n_output_groups);
+        }
+      else if (n_mpi_processes > 1)
+        {
+          fname = output_file_name(this_mpi_process, n_mpi_processes);
         }
       else
         {
@@ -166,8 +509,29 @@ ParsedDataOut<dim, spacedim>::prepare_data_output(
         }
 
       deallog << "Will write on file: " << fname.c_str() << std::endl;
-      output_file.open(fname.c_str());
-      AssertThrow(output_file, ExcIO());
+
+      // Grouped and hdf5 files are opened collectively when writing.
+      if (!grouped_output() && output_format != "hdf5")
+        {
+          output_file.open(fname.c_str());
+          AssertThrow(output_file, ExcIO());
+        }
+
+      // Keep track of changes in the mesh, so that hdf5 meshes are
+      // written, and cached patches are rebuilt, only when needed.
+      if ((output_format == "hdf5" || cache_patches) &&
+          &dh.get_triangulation() != output_triangulation)
+        {
+          tria_connection.disconnect();
+          output_triangulation = &dh.get_triangulation();
+          tria_connection = output_triangulation->signals.any_change.connect(
+            [this]() {
+              mesh_changed = true;
+              cached_patches.clear();
+            });
+          mesh_changed = true;
+          cached_patches.clear();
+        }
       data_out->attach_dof_handler(dh);
 
       if (n_mpi_processes > 1)
@@ -186,7 +550,8 @@ ParsedDataOut<dim, spacedim>::prepare_data_output(
             }
         }
     }
-  initialized = true;
+  has_postprocessed_data = false;
+  initialized            = true;
   deallog.pop();
 }
 
@@ -211,28 +576,73 @@ ParsedDataOut<dim, spacedim>::write_data_and_clear(
         }
     }
   AssertThrow(initialized, ExcNotInitialized());
-  AssertThrow(output_file, ExcIO());
+  AssertThrow(grouped_output() || output_format == "hdf5" || output_file,
+              ExcIO());
   deallog.push("WritingData");
   if (data_out->default_suffix() != "")
     {
-      data_out->build_patches(mapping,
-                              subdivisions,
-                              DataOut<dim, spacedim>::curved_inner_cells);
-      data_out->write(output_file);
-      deallog << "Wrote output file." << std::endl;
+      build_patches(mapping);
+
+      const bool write_pvtu = (this_mpi_process == 0 && n_mpi_processes > 1 &&
+                               data_out->default_suffix() == ".vtu");
+      const std::string        pvtu_name = current_name + ".pvtu";
+      std::vector<std::string> filenames;
+      if (write_pvtu)
+        {
+          const unsigned int n_files =
+            (grouped_output() ? n_output_groups : n_mpi_processes);
+          for (unsigned int i = 0; i < n_files; ++i)
+            filenames.push_back(output_file_name(i, n_files));
+        }
 
-      if (this_mpi_process == 0 && n_mpi_processes > 1 &&
-          data_out->default_suffix() == ".vtu")
+      // Collective writes cannot be delegated to the writer thread.
+      if (output_format == "hdf5")
+        {
+          write_hdf5_data(mapping);
+        }
+      else if (grouped_output())
+        {
+          data_out->write_vtu_in_parallel(
+            output_file_name(output_group, n_output_groups), group_comm);
+          deallog << "Wrote output file." << std::endl;
+
+          if (write_pvtu)
+            {
+              std::ofstream master_output(pvtu_name.c_str());
+              data_out->write_pvtu_record(master_output, filenames);
+            }
+        }
+      else if (asynchronous_output)
+        {
+          const auto snapshot =
+            static_cast<SnapshotDataOut<dim, spacedim> &>(*data_out)
+              .snapshot(DataOutBase::parse_output_format(output_format));
+          const auto file =
+            std::make_shared<std::ofstream>(std::move(output_file));
+
+          enqueue_output([snapshot, file, write_pvtu, pvtu_name, filenames]() {
+            snapshot->write(*file);
+            file->close();
+            AssertThrow(*file, ExcIO());
+
+            if (write_pvtu)
+              {
+                std::ofstream master_output(pvtu_name.c_str());
+                snapshot->write_pvtu_record(master_output, filenames);
+              }
+          });
+          deallog << "Queued output file." << std::endl;
+        }
+      else
         {
-          std::vector<std::string> filenames;
-          for (unsigned int i = 0; i < n_mpi_processes; ++i)
-            filenames.push_back(current_name + "." +
-                                Utilities::int_to_string(i, 2) + "." +
-                                Utilities::int_to_string(n_mpi_processes, 2) +
-                                data_out->default_suffix());
+          data_out->write(output_file);
+          deallog << "Wrote output file." << std::endl;
 
-          std::ofstream master_output((current_name + ".pvtu").c_str());
-          data_out->write_pvtu_record(master_output, filenames);
+          if (write_pvtu)
+            {
+              std::ofstream master_output(pvtu_name.c_str());
+              data_out->write_pvtu_record(master_output, filenames);
+            }
         }
     }
   data_out = 0;
@@ -243,6 +653,195 @@ ParsedDataOut<dim, spacedim>::write_data_and_clear(
 }
 
 
+
+template <int dim, int spacedim>
+void
+ParsedDataOut<dim, spacedim>::invalidate_geometry()
+{
+  cached_patches.clear();
+  mesh_changed = true;
+}
+
+
+
+template <int dim, int spacedim>
+void
+ParsedDataOut<dim, spacedim>::build_patches(
+  const Mapping<dim, spacedim> &mapping)
+{
+  auto &out = static_cast<SnapshotDataOut<dim, spacedim> &>(*data_out);
+
+  if (!cache_patches || has_postprocessed_data)
+    {
+      out.build_patches(mapping,
+                        subdivisions,
+                        DataOut<dim, spacedim>::curved_inner_cells);
+      return;
+    }
+
+  if (!cached_patches.empty() && &mapping == cached_mapping &&
+      subdivisions == cached_subdivisions)
+    {
+      // The values of the data do not depend on the mapping, so a
+      // linear one is enough here.
+      out.build_patches(subdivisions);
+      if (restore_geometry(out.get_patches_for_cache(), cached_patches))
+        {
+          deallog << "Reused cached patches." << std::endl;
+          return;
+        }
+    }
+
+  out.build_patches(mapping,
+                    subdivisions,
+                    DataOut<dim, spacedim>::curved_inner_cells);
+  cached_patches      = extract_geometry(out.get_patches_for_cache());
+  cached_mapping      = &mapping;
+  cached_subdivisions = subdivisions;
+}
+
+
+
+template <int dim, int spacedim>
+void
+ParsedDataOut<dim, spacedim>::write_hdf5_data(
+  const Mapping<dim, spacedim> &mapping)
+{
+  if (&mapping != hdf5_mapping)
+    {
+      hdf5_mapping = &mapping;
+      mesh_changed = true;
+    }
+
+  DataOutBase::DataOutFilter data_filter(
+    DataOutBase::DataOutFilterFlags(true, true));
+  data_out->write_filtered_data(data_filter);
+
+  // File names in the xdmf file are relative to its directory.
+  if (mesh_changed)
+    hdf5_mesh_name = base_name + "_mesh." +
+                     Utilities::int_to_string(n_hdf5_meshes++, 3) + ".h5";
+  const std::string solution_name =
+    current_name.substr(path_solution_dir.size()) + ".h5";
+
+  data_out->write_hdf5_parallel(data_filter,
+                                mesh_changed,
+                                path_solution_dir + hdf5_mesh_name,
+                                path_solution_dir + solution_name,
+                                comm);
+  if (mesh_changed)
+    deallog << "Wrote mesh file." << std::endl;
+  deallog << "Wrote output file." << std::endl;
+  mesh_changed = false;
+
+  const double time = (output_time_set ? output_time : xdmf_entries.size());
+  xdmf_entries.push_back(data_out->create_xdmf_entry(
+    data_filter, hdf5_mesh_name, solution_name, time, comm));
+  data_out->write_xdmf_file(xdmf_entries,
+                            path_solution_dir + base_name + ".xdmf",
+                            comm);
+}
+
+
+
+template <int dim, int spacedim>
+void
+ParsedDataOut<dim, spacedim>::set_time(const double time)
+{
+  output_time     = time;
+  output_time_set = true;
+}
+
+
+
+template <int dim, int spacedim>
+void
+ParsedDataOut<dim, spacedim>::wait_for_pending_output()
+{
+  std::unique_lock<std::mutex> lock(writer_mutex);
+  writer_condition.wait(lock, [this]() {
+    return pending_outputs.empty() && !writing_output;
+  });
+
+  if (writer_exception)
+    {
+      std::exception_ptr exc = writer_exception;
+      writer_exception       = nullptr;
+      std::rethrow_exception(exc);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+ParsedDataOut<dim, spacedim>::enqueue_output(const std::function<void()> &job)
+{
+  std::unique_lock<std::mutex> lock(writer_mutex);
+
+  if (writer_exception)
+    {
+      std::exception_ptr exc = writer_exception;
+      writer_exception       = nullptr;
+      std::rethrow_exception(exc);
+    }
+
+  writer_condition.wait(lock, [this]() {
+    return pending_outputs.size() + (writing_output ? 1 : 0) <
+           max_pending_outputs;
+  });
+
+  pending_outputs.push_back(job);
+
+  if (!writer_thread.joinable())
+    writer_thread =
+      std::thread(&ParsedDataOut<dim, spacedim>::writer_loop, this);
+
+  lock.unlock();
+  writer_condition.notify_all();
+}
+
+
+
+template <int dim, int spacedim>
+void
+ParsedDataOut<dim, spacedim>::writer_loop()
+{
+  std::unique_lock<std::mutex> lock(writer_mutex);
+  while (true)
+    {
+      writer_condition.wait(lock, [this]() {
+        return stop_writer || !pending_outputs.empty();
+      });
+
+      // Only stop once everything has been written.
+      if (pending_outputs.empty())
+        return;
+
+      const std::function<void()> job = std::move(pending_outputs.front());
+      pending_outputs.pop_front();
+      writing_output = true;
+      lock.unlock();
+
+      std::exception_ptr exc;
+      try
+        {
+          job();
+        }
+      catch (...)
+        {
+          exc = std::current_exception();
+        }
+
+      lock.lock();
+      if (exc)
+        writer_exception = exc;
+      writing_output = false;
+      writer_condition.notify_all();
+    }
+}
+
+
 D2K_NAMESPACE_CLOSE
 
 template class deal2lkit::ParsedDataOut<1, 1>;
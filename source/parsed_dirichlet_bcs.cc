@@ -13,10 +13,102 @@
 //
 //-----------------------------------------------------------
 
+#include <deal.II/base/work_stream.h>
+
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q1.h>
+
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+
 #include <deal2lkit/parsed_dirichlet_bcs.h>
 
+#include <functional>
+#include <set>
+#include <tuple>
+
 using namespace dealii;
 
+namespace
+{
+  using ProjectionVector = LinearAlgebra::distributed::Vector<double>;
+
+  /**
+   * The mass matrix of the boundary dofs of one id, stored as the local
+   * matrices of the locally owned boundary faces, together with the
+   * local right hand sides.
+   */
+  class BoundaryMassMatrix
+  {
+  public:
+    void
+    vmult(ProjectionVector &dst, const ProjectionVector &src) const
+    {
+      dst = 0;
+      src.update_ghost_values();
+      Vector<double> local_src, local_dst;
+      for (unsigned int f = 0; f < dofs.size(); ++f)
+        {
+          local_src.reinit(dofs[f].size());
+          local_dst.reinit(dofs[f].size());
+          for (unsigned int i = 0; i < dofs[f].size(); ++i)
+            local_src(i) = src(dofs[f][i]);
+          matrices[f].vmult(local_dst, local_src);
+          for (unsigned int i = 0; i < dofs[f].size(); ++i)
+            dst(dofs[f][i]) += local_dst(i);
+        }
+      dst.compress(VectorOperation::add);
+      src.zero_out_ghost_values();
+    }
+
+    std::vector<std::vector<types::global_dof_index>> dofs;
+    std::vector<FullMatrix<double>>                   matrices;
+    std::vector<Vector<double>>                       rhs;
+  };
+
+  template <int dim, int spacedim>
+  struct ProjectionScratch
+  {
+    ProjectionScratch(const Mapping<dim, spacedim> &      mapping,
+                      const FiniteElement<dim, spacedim> &fe,
+                      const Quadrature<dim - 1> &         quadrature)
+      : fe_face_values(mapping,
+                       fe,
+                       quadrature,
+                       update_values | update_quadrature_points |
+                         update_JxW_values)
+      , values(quadrature.size(), Vector<double>(fe.n_components()))
+    {}
+
+    ProjectionScratch(const ProjectionScratch &scratch)
+      : fe_face_values(scratch.fe_face_values.get_mapping(),
+                       scratch.fe_face_values.get_fe(),
+                       scratch.fe_face_values.get_quadrature(),
+                       scratch.fe_face_values.get_update_flags())
+      , values(scratch.values)
+    {}
+
+    FEFaceValues<dim, spacedim> fe_face_values;
+    std::vector<Vector<double>> values;
+  };
+
+  /**
+   * The local matrices and right hand sides of the boundary faces of a
+   * cell, with the index of the id of each face.
+   */
+  struct ProjectionCopy
+  {
+    std::vector<unsigned int>                         id_indices;
+    std::vector<std::vector<types::global_dof_index>> dofs;
+    std::vector<FullMatrix<double>>                   matrices;
+    std::vector<Vector<double>>                       rhs;
+  };
+} // namespace
+
 D2K_NAMESPACE_OPEN
 
 template <int dim, int spacedim>
@@ -50,20 +142,149 @@ ParsedDirichletBCs<dim, spacedim>::parse_parameters_call_back()
   ParsedMappedFunctions<spacedim>::parse_parameters_call_back();
 }
 
+template <int dim, int spacedim>
+bool
+ParsedDirichletBCs<dim, spacedim>::collect_boundary_dofs(
+  const Mapping<dim, spacedim> &   mapping,
+  const DoFHandler<dim, spacedim> &dof_handler,
+  const bool                       first_id_wins,
+  BoundaryDoFs &                   boundary_dofs) const
+{
+  boundary_dofs = BoundaryDoFs();
+
+  // In 1d the faces are vertices, and there are at most two ids.
+  if (dim == 1 || dof_handler.get_fe_collection().size() != 1)
+    return false;
+
+  const FiniteElement<dim, spacedim> &fe = dof_handler.get_fe();
+  if (fe.dofs_per_face == 0)
+    return true;
+  if (!fe.is_primitive() || !fe.has_face_support_points())
+    return false;
+
+  const std::vector<unsigned int> ids = this->get_mapped_ids();
+  std::map<types::boundary_id, unsigned int> id_index;
+  std::vector<ComponentMask>                 masks;
+  for (unsigned int i = 0; i < ids.size(); ++i)
+    {
+      id_index.emplace(ids[i], i);
+      masks.push_back(this->get_mapped_mask(ids[i]));
+    }
+
+  const Quadrature<dim - 1>   quadrature(fe.get_unit_face_support_points());
+  FEFaceValues<dim, spacedim> fe_face_values(mapping,
+                                             fe,
+                                             quadrature,
+                                             update_quadrature_points);
+
+  std::vector<types::global_dof_index> face_dofs(fe.dofs_per_face);
+
+  // Index of the id, component and support point of every boundary dof.
+  std::map<types::global_dof_index,
+           std::tuple<unsigned int, unsigned int, Point<spacedim>>>
+    owners;
+
+  for (const auto &cell : dof_handler.active_cell_iterators())
+    if (!cell->is_artificial())
+      for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell; ++f)
+        if (cell->face(f)->at_boundary())
+          {
+            const auto id = id_index.find(cell->face(f)->boundary_id());
+            if (id == id_index.end())
+              continue;
+
+            fe_face_values.reinit(cell, f);
+            cell->face(f)->get_dof_indices(face_dofs);
+            const std::vector<Point<spacedim>> &points =
+              fe_face_values.get_quadrature_points();
+
+            for (unsigned int i = 0; i < fe.dofs_per_face; ++i)
+              {
+                const unsigned int c =
+                  fe.face_system_to_component_index(i).first;
+                if (!masks[id->second][c])
+                  continue;
+
+                const auto owner = owners.find(face_dofs[i]);
+                if (owner == owners.end())
+                  owners.emplace(face_dofs[i],
+                                 std::make_tuple(id->second, c, points[i]));
+                else if (first_id_wins ?
+                           id->second < std::get<0>(owner->second) :
+                           id->second > std::get<0>(owner->second))
+                  owner->second = std::make_tuple(id->second, c, points[i]);
+              }
+          }
+
+  // Group the dofs by id, in the order of get_mapped_ids(), keeping
+  // them sorted.
+  BoundaryDoFs by_id;
+  by_id.dofs.resize(ids.size());
+  by_id.components.resize(ids.size());
+  by_id.points.resize(ids.size());
+  for (const auto &owner : owners)
+    {
+      const unsigned int i = std::get<0>(owner.second);
+      by_id.dofs[i].push_back(owner.first);
+      by_id.components[i].push_back(std::get<1>(owner.second));
+      by_id.points[i].push_back(std::get<2>(owner.second));
+    }
+
+  for (unsigned int i = 0; i < ids.size(); ++i)
+    if (by_id.dofs[i].size() > 0)
+      {
+        boundary_dofs.ids.push_back(ids[i]);
+        boundary_dofs.dofs.push_back(std::move(by_id.dofs[i]));
+        boundary_dofs.components.push_back(std::move(by_id.components[i]));
+        boundary_dofs.points.push_back(std::move(by_id.points[i]));
+      }
+
+  return true;
+}
+
+template <int dim, int spacedim>
+std::vector<double>
+ParsedDirichletBCs<dim, spacedim>::evaluate_boundary_values(
+  const BoundaryDoFs &boundary_dofs,
+  const unsigned int  b) const
+{
+  const auto function = this->get_mapped_function(boundary_dofs.ids[b]);
+  const auto &components = boundary_dofs.components[b];
+  const auto &points     = boundary_dofs.points[b];
+
+  // Evaluate all the points of each component with a single call of
+  // value_list(), which is batched by ParsedBatchFunction.
+  std::vector<double> values(components.size());
+  for (unsigned int c = 0; c < function->n_components; ++c)
+    {
+      std::vector<unsigned int>    indices;
+      std::vector<Point<spacedim>> component_points;
+      for (unsigned int i = 0; i < components.size(); ++i)
+        if (components[i] == c)
+          {
+            indices.push_back(i);
+            component_points.push_back(points[i]);
+          }
+      if (indices.empty())
+        continue;
+
+      std::vector<double> component_values(indices.size());
+      function->value_list(component_points, component_values, c);
+      for (unsigned int i = 0; i < indices.size(); ++i)
+        values[indices[i]] = component_values[i];
+    }
+  return values;
+}
+
 template <int dim, int spacedim>
 void
 ParsedDirichletBCs<dim, spacedim>::interpolate_boundary_values(
   const DoFHandler<dim, spacedim> &  dof_handler,
   dealii::AffineConstraints<double> &constraints) const
 {
-  std::vector<unsigned int> ids = this->get_mapped_ids();
-  for (unsigned int i = 0; i < ids.size(); ++i)
-    VectorTools::interpolate_boundary_values(dof_handler,
-                                             ids[i],
-                                             *(this->get_mapped_function(
-                                               ids[i])),
-                                             constraints,
-                                             this->get_mapped_mask(ids[i]));
+  interpolate_boundary_values(StaticMappingQ1<dim, spacedim>::mapping,
+                              dof_handler,
+                              constraints);
 }
 
 template <int dim, int spacedim>
@@ -73,15 +294,160 @@ ParsedDirichletBCs<dim, spacedim>::interpolate_boundary_values(
   const DoFHandler<dim, spacedim> &  dof_handler,
   dealii::AffineConstraints<double> &constraints) const
 {
-  std::vector<unsigned int> ids = this->get_mapped_ids();
-  for (unsigned int i = 0; i < ids.size(); ++i)
-    VectorTools::interpolate_boundary_values(mapping,
-                                             dof_handler,
-                                             ids[i],
-                                             *(this->get_mapped_function(
-                                               ids[i])),
-                                             constraints,
-                                             this->get_mapped_mask(ids[i]));
+  constrained_dofs_are_valid = false;
+  constrained_dofs           = BoundaryDoFs();
+  constrained_values.clear();
+  dependent_lines.clear();
+
+  BoundaryDoFs boundary_dofs;
+  if (!collect_boundary_dofs(mapping, dof_handler, true, boundary_dofs))
+    {
+      std::vector<unsigned int> ids = this->get_mapped_ids();
+      for (unsigned int i = 0; i < ids.size(); ++i)
+        VectorTools::interpolate_boundary_values(
+          mapping,
+          dof_handler,
+          ids[i],
+          *(this->get_mapped_function(ids[i])),
+          constraints,
+          this->get_mapped_mask(ids[i]));
+      return;
+    }
+
+  // Same as VectorTools::interpolate_boundary_values: the dofs which are
+  // already constrained are left untouched. The other ones are cached
+  // for update_inhomogeneities().
+  for (unsigned int b = 0; b < boundary_dofs.ids.size(); ++b)
+    {
+      const auto values = evaluate_boundary_values(boundary_dofs, b);
+
+      constrained_dofs.ids.push_back(boundary_dofs.ids[b]);
+      constrained_dofs.dofs.emplace_back();
+      constrained_dofs.components.emplace_back();
+      constrained_dofs.points.emplace_back();
+      constrained_values.emplace_back();
+      for (unsigned int i = 0; i < values.size(); ++i)
+        {
+          const types::global_dof_index dof = boundary_dofs.dofs[b][i];
+          if (constraints.can_store_line(dof) &&
+              !constraints.is_constrained(dof))
+            {
+              constraints.add_line(dof);
+              constraints.set_inhomogeneity(dof, values[i]);
+
+              constrained_values.back().push_back(values[i]);
+              constrained_dofs.dofs.back().push_back(dof);
+              constrained_dofs.components.back().push_back(
+                boundary_dofs.components[b][i]);
+              constrained_dofs.points.back().push_back(
+                boundary_dofs.points[b][i]);
+            }
+        }
+    }
+
+  // The lines which depend, possibly through other lines, on the
+  // boundary dofs. Their inhomogeneities change with the boundary values
+  // once the constraints are closed.
+  std::set<types::global_dof_index> affected;
+  for (const auto &dofs : constrained_dofs.dofs)
+    affected.insert(dofs.begin(), dofs.end());
+
+  std::map<types::global_dof_index, DependentLine> lines;
+  for (bool changed = true; changed;)
+    {
+      changed = false;
+      for (const auto &line : constraints.get_lines())
+        if (affected.find(line.index) == affected.end())
+          for (const auto &entry : line.entries)
+            if (affected.find(entry.first) != affected.end())
+              {
+                affected.insert(line.index);
+                lines[line.index] = {line.index,
+                                     line.inhomogeneity,
+                                     line.entries};
+                changed = true;
+                break;
+              }
+    }
+
+  // Keep only the entries which refer to constrained dofs, and sort the
+  // lines such that each one follows the lines it refers to.
+  std::set<types::global_dof_index>                  sorted;
+  std::function<void(const types::global_dof_index)> sort_line =
+    [&](const types::global_dof_index index) {
+      const auto line = lines.find(index);
+      if (line == lines.end() || !sorted.insert(index).second)
+        return;
+      DependentLine dependent = line->second;
+      dependent.entries.clear();
+      for (const auto &entry : line->second.entries)
+        if (constraints.can_store_line(entry.first) &&
+            constraints.is_constrained(entry.first))
+          {
+            sort_line(entry.first);
+            dependent.entries.push_back(entry);
+          }
+      dependent_lines.push_back(dependent);
+    };
+  for (const auto &line : lines)
+    sort_line(line.first);
+
+  constrained_dofs_are_valid = true;
+}
+
+template <int dim, int spacedim>
+void
+ParsedDirichletBCs<dim, spacedim>::update_inhomogeneities(
+  const double               t,
+  AffineConstraints<double> &constraints)
+{
+  AssertThrow(constrained_dofs_are_valid,
+              ExcMessage("update_inhomogeneities() requires a previous call "
+                         "of interpolate_boundary_values() on an "
+                         "AffineConstraints object, with a finite element "
+                         "which has support points on the faces."));
+
+  this->set_time(t);
+
+  // The values of the ids whose expressions do not depend on the time
+  // are the cached ones, which are already stored in the constraints.
+  bool changed = false;
+  for (unsigned int b = 0; b < constrained_dofs.ids.size(); ++b)
+    if (this->is_time_dependent(constrained_dofs.ids[b]))
+      {
+        constrained_values[b] = evaluate_boundary_values(constrained_dofs, b);
+        for (unsigned int i = 0; i < constrained_values[b].size(); ++i)
+          constraints.set_inhomogeneity(constrained_dofs.dofs[b][i],
+                                        constrained_values[b][i]);
+        changed = true;
+      }
+
+  if (!changed)
+    return;
+
+  std::map<types::global_dof_index, double> inhomogeneities;
+  for (unsigned int b = 0; b < constrained_dofs.ids.size(); ++b)
+    for (unsigned int i = 0; i < constrained_values[b].size(); ++i)
+      inhomogeneities[constrained_dofs.dofs[b][i]] = constrained_values[b][i];
+
+  // close() has moved the inhomogeneities of the constrained dofs into
+  // the lines which refer to them. Those of the lines which do not
+  // depend on the boundary dofs are already final.
+  if (constraints.is_closed())
+    for (const auto &line : dependent_lines)
+      {
+        double inhomogeneity = line.inhomogeneity;
+        for (const auto &entry : line.entries)
+          {
+            const auto known = inhomogeneities.find(entry.first);
+            inhomogeneity +=
+              entry.second * (known != inhomogeneities.end() ?
+                                known->second :
+                                constraints.get_inhomogeneity(entry.first));
+          }
+        constraints.set_inhomogeneity(line.index, inhomogeneity);
+        inhomogeneities[line.index] = inhomogeneity;
+      }
 }
 
 template <int dim, int spacedim>
@@ -90,14 +456,9 @@ ParsedDirichletBCs<dim, spacedim>::interpolate_boundary_values(
   const DoFHandler<dim, spacedim> &          dof_handler,
   std::map<types::global_dof_index, double> &d_dofs) const
 {
-  std::vector<unsigned int> ids = this->get_mapped_ids();
-  for (unsigned int i = 0; i < ids.size(); ++i)
-    VectorTools::interpolate_boundary_values(dof_handler,
-                                             ids[i],
-                                             *(this->get_mapped_function(
-                                               ids[i])),
-                                             d_dofs,
-                                             this->get_mapped_mask(ids[i]));
+  interpolate_boundary_values(StaticMappingQ1<dim, spacedim>::mapping,
+                              dof_handler,
+                              d_dofs);
 }
 
 template <int dim, int spacedim>
@@ -107,15 +468,218 @@ ParsedDirichletBCs<dim, spacedim>::interpolate_boundary_values(
   const DoFHandler<dim, spacedim> &          dof_handler,
   std::map<types::global_dof_index, double> &d_dofs) const
 {
-  std::vector<unsigned int> ids = this->get_mapped_ids();
+  BoundaryDoFs boundary_dofs;
+  if (!collect_boundary_dofs(mapping, dof_handler, false, boundary_dofs))
+    {
+      std::vector<unsigned int> ids = this->get_mapped_ids();
+      for (unsigned int i = 0; i < ids.size(); ++i)
+        VectorTools::interpolate_boundary_values(
+          mapping,
+          dof_handler,
+          ids[i],
+          *(this->get_mapped_function(ids[i])),
+          d_dofs,
+          this->get_mapped_mask(ids[i]));
+      return;
+    }
+
+  for (unsigned int b = 0; b < boundary_dofs.ids.size(); ++b)
+    {
+      const auto values = evaluate_boundary_values(boundary_dofs, b);
+      for (unsigned int i = 0; i < values.size(); ++i)
+        d_dofs[boundary_dofs.dofs[b][i]] = values[i];
+    }
+}
+
+
+template <int dim, int spacedim>
+bool
+ParsedDirichletBCs<dim, spacedim>::project_all_boundary_values(
+  const Mapping<dim, spacedim> &                          mapping,
+  const DoFHandler<dim, spacedim> &                       dof_handler,
+  const Quadrature<dim - 1> &                             quadrature,
+  std::vector<std::map<types::global_dof_index, double>> &boundary_values)
+  const
+{
+  if (dim == 1 || dof_handler.get_fe_collection().size() != 1)
+    return false;
+
+  const FiniteElement<dim, spacedim> &fe = dof_handler.get_fe();
+  if (!fe.is_primitive())
+    return false;
+
+  const std::vector<unsigned int> ids = this->get_mapped_ids();
+  std::map<types::boundary_id, unsigned int> id_index;
+  std::vector<ComponentMask>                 masks;
   for (unsigned int i = 0; i < ids.size(); ++i)
-    VectorTools::interpolate_boundary_values(mapping,
-                                             dof_handler,
-                                             ids[i],
-                                             *(this->get_mapped_function(
-                                               ids[i])),
-                                             d_dofs,
-                                             this->get_mapped_mask(ids[i]));
+    {
+      id_index.emplace(ids[i], i);
+      masks.push_back(this->get_mapped_mask(ids[i]));
+    }
+
+#if DEAL_II_VERSION_GTE(9, 4, 0)
+  const IndexSet relevant_dofs =
+    DoFTools::extract_locally_relevant_dofs(dof_handler);
+#else
+  IndexSet relevant_dofs;
+  DoFTools::extract_locally_relevant_dofs(dof_handler, relevant_dofs);
+#endif
+  const MPI_Comm communicator =
+    dof_handler.get_triangulation().get_communicator();
+
+  // On three dimensional meshes, the boundary faces next to finer ones
+  // have hanging nodes on their edges, which are constrained to the
+  // other boundary dofs. VectorTools::project_boundary_values takes care
+  // of them: let the caller use it.
+  if (dim == 3)
+    {
+      unsigned int has_hanging_nodes = 0;
+      for (const auto &cell : dof_handler.active_cell_iterators())
+        if (cell->is_locally_owned())
+          for (unsigned int l = 0; l < GeometryInfo<dim>::lines_per_cell; ++l)
+            if (cell->line(l)->at_boundary() && cell->line(l)->has_children())
+              has_hanging_nodes = 1;
+      if (Utilities::MPI::max(has_hanging_nodes, communicator) != 0)
+        return false;
+    }
+
+  // Local mass matrices and right hand sides of the locally owned
+  // boundary faces of each id, restricted to the dofs of the components
+  // selected by its mask.
+  std::vector<BoundaryMassMatrix> matrices(ids.size());
+
+  const auto worker =
+    [&](const typename DoFHandler<dim, spacedim>::active_cell_iterator &cell,
+        ProjectionScratch<dim, spacedim> &scratch,
+        ProjectionCopy &                  copy) {
+      copy.id_indices.clear();
+      copy.dofs.clear();
+      copy.matrices.clear();
+      copy.rhs.clear();
+      if (!cell->is_locally_owned())
+        return;
+
+      std::vector<types::global_dof_index> cell_dofs(fe.dofs_per_cell);
+      cell->get_dof_indices(cell_dofs);
+
+      for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell; ++f)
+        if (cell->face(f)->at_boundary())
+          {
+            const auto id = id_index.find(cell->face(f)->boundary_id());
+            if (id == id_index.end())
+              continue;
+
+            std::vector<unsigned int> local_dofs;
+            for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+              if (fe.has_support_on_face(i, f) &&
+                  masks[id->second][fe.system_to_component_index(i).first])
+                local_dofs.push_back(i);
+            if (local_dofs.size() == 0)
+              continue;
+
+            scratch.fe_face_values.reinit(cell, f);
+            this->get_mapped_function(ids[id->second])
+              ->vector_value_list(
+                scratch.fe_face_values.get_quadrature_points(),
+                scratch.values);
+
+            const unsigned int n = local_dofs.size();
+            FullMatrix<double> local_matrix(n, n);
+            Vector<double>     local_rhs(n);
+            for (unsigned int q = 0; q < quadrature.size(); ++q)
+              for (unsigned int i = 0; i < n; ++i)
+                {
+                  const unsigned int c =
+                    fe.system_to_component_index(local_dofs[i]).first;
+                  const double phi_i =
+                    scratch.fe_face_values.shape_value(local_dofs[i], q) *
+                    scratch.fe_face_values.JxW(q);
+                  local_rhs(i) += scratch.values[q](c) * phi_i;
+                  for (unsigned int j = 0; j < n; ++j)
+                    if (fe.system_to_component_index(local_dofs[j]).first ==
+                        c)
+                      local_matrix(i, j) +=
+                        scratch.fe_face_values.shape_value(local_dofs[j], q) *
+                        phi_i;
+                }
+
+            copy.id_indices.push_back(id->second);
+            copy.dofs.emplace_back(n);
+            for (unsigned int i = 0; i < n; ++i)
+              copy.dofs.back()[i] = cell_dofs[local_dofs[i]];
+            copy.matrices.push_back(local_matrix);
+            copy.rhs.push_back(local_rhs);
+          }
+    };
+
+  const auto copier = [&](const ProjectionCopy &copy) {
+    for (unsigned int f = 0; f < copy.dofs.size(); ++f)
+      {
+        BoundaryMassMatrix &matrix = matrices[copy.id_indices[f]];
+        matrix.dofs.push_back(copy.dofs[f]);
+        matrix.matrices.push_back(copy.matrices[f]);
+        matrix.rhs.push_back(copy.rhs[f]);
+      }
+  };
+
+  WorkStream::run(dof_handler.begin_active(),
+                  dof_handler.end(),
+                  worker,
+                  copier,
+                  ProjectionScratch<dim, spacedim>(mapping, fe, quadrature),
+                  ProjectionCopy());
+
+  ProjectionVector rhs(dof_handler.locally_owned_dofs(),
+                       relevant_dofs,
+                       communicator);
+  ProjectionVector diagonal(rhs), solution(rhs);
+  DiagonalMatrix<ProjectionVector> preconditioner;
+  preconditioner.get_vector().reinit(rhs);
+
+  // The ids are projected one at a time, as by
+  // VectorTools::project_boundary_values, so that the values of the dofs
+  // shared by several ids do not depend on the other ids.
+  boundary_values.assign(ids.size(),
+                         std::map<types::global_dof_index, double>());
+  for (unsigned int b = 0; b < ids.size(); ++b)
+    {
+      const BoundaryMassMatrix &matrix = matrices[b];
+
+      rhs      = 0;
+      diagonal = 0;
+      for (unsigned int f = 0; f < matrix.dofs.size(); ++f)
+        for (unsigned int i = 0; i < matrix.dofs[f].size(); ++i)
+          {
+            rhs(matrix.dofs[f][i]) += matrix.rhs[f](i);
+            diagonal(matrix.dofs[f][i]) += matrix.matrices[f](i, i);
+          }
+      rhs.compress(VectorOperation::add);
+      diagonal.compress(VectorOperation::add);
+
+      // The mass matrix vanishes on the dofs which are not projected,
+      // where the right hand side, and therefore the solution, is zero.
+      preconditioner.get_vector() = 0;
+      for (unsigned int i = 0; i < diagonal.locally_owned_size(); ++i)
+        if (diagonal.local_element(i) != 0)
+          preconditioner.get_vector().local_element(i) =
+            1. / diagonal.local_element(i);
+
+      solution = 0;
+      SolverControl              control(dof_handler.n_dofs() + 100,
+                                         1e-12 * rhs.l2_norm());
+      SolverCG<ProjectionVector> cg(control);
+      cg.solve(matrix, solution, rhs, preconditioner);
+
+      solution.update_ghost_values();
+      diagonal.update_ghost_values();
+      for (const auto dof : relevant_dofs)
+        if (diagonal(dof) != 0)
+          boundary_values[b][dof] = solution(dof);
+      solution.zero_out_ghost_values();
+      diagonal.zero_out_ghost_values();
+    }
+
+  return true;
 }
 
 
@@ -194,6 +758,25 @@ ParsedDirichletBCs<dim, spacedim>::project_boundary_values(
   const Quadrature<dim - 1> &      quadrature,
   AffineConstraints<double> &      constraints) const
 {
+  // As with VectorTools::project_boundary_values, the dofs shared by
+  // several ids take the value of the first one.
+  std::vector<std::map<types::global_dof_index, double>> boundary_values;
+  if (project_all_boundary_values(mapping,
+                                  dof_handler,
+                                  quadrature,
+                                  boundary_values))
+    {
+      for (const auto &id_values : boundary_values)
+        for (const auto &value : id_values)
+          if (constraints.can_store_line(value.first) &&
+              !constraints.is_constrained(value.first))
+            {
+              constraints.add_line(value.first);
+              constraints.set_inhomogeneity(value.first, value.second);
+            }
+      return;
+    }
+
   std::vector<unsigned int> ids = this->get_mapped_ids();
   for (unsigned int i = 0; i < ids.size(); ++i)
     {
@@ -226,25 +809,10 @@ ParsedDirichletBCs<dim, spacedim>::project_boundary_values(
   const Quadrature<dim - 1> &      quadrature,
   AffineConstraints<double> &      constraints) const
 {
-  std::vector<unsigned int> ids = this->get_mapped_ids();
-  for (unsigned int i = 0; i < ids.size(); ++i)
-    {
-      std::map<types::boundary_id, const Function<dim> *> boundary_map;
-
-      Function<spacedim> *f;
-      f                    = &(*(this->get_mapped_function(ids[i])));
-      boundary_map[ids[i]] = f;
-
-      // from bool to int
-      std::vector<unsigned int> component_mapping;
-      if (spacedim >
-          1) // component_mapping is not supported in deal.II for dim==1
-        for (unsigned int j = 0; j < component_mapping.size(); ++j)
-          component_mapping.push_back(this->get_mapped_mask(ids[i])[j]);
-
-      VectorTools::project_boundary_values(
-        dof_handler, boundary_map, quadrature, constraints, component_mapping);
-    }
+  project_boundary_values(StaticMappingQ1<dim, spacedim>::mapping,
+                          dof_handler,
+                          quadrature,
+                          constraints);
 }
 
 template <>
@@ -288,6 +856,20 @@ ParsedDirichletBCs<dim, spacedim>::project_boundary_values(
   const Quadrature<dim - 1> &                quadrature,
   std::map<types::global_dof_index, double> &projected_bv) const
 {
+  // As with VectorTools::project_boundary_values, the dofs shared by
+  // several ids take the value of the last one.
+  std::vector<std::map<types::global_dof_index, double>> boundary_values;
+  if (project_all_boundary_values(mapping,
+                                  dof_handler,
+                                  quadrature,
+                                  boundary_values))
+    {
+      for (const auto &id_values : boundary_values)
+        for (const auto &value : id_values)
+          projected_bv[value.first] = value.second;
+      return;
+    }
+
   std::vector<unsigned int> ids = this->get_mapped_ids();
   for (unsigned int i = 0; i < ids.size(); ++i)
     {
@@ -354,25 +936,10 @@ ParsedDirichletBCs<dim, spacedim>::project_boundary_values(
   const Quadrature<dim - 1> &                quadrature,
   std::map<types::global_dof_index, double> &projected_bv) const
 {
-  std::vector<unsigned int> ids = this->get_mapped_ids();
-  for (unsigned int i = 0; i < ids.size(); ++i)
-    {
-      std::map<types::boundary_id, const Function<dim> *> boundary_map;
-
-      Function<spacedim> *f;
-      f                    = &(*(this->get_mapped_function(ids[i])));
-      boundary_map[ids[i]] = f;
-
-      // from bool to int
-      std::vector<unsigned int> component_mapping;
-      if (spacedim >
-          1) // component_mapping is not supported in deal.II for dim==1
-        for (unsigned int j = 0; j < n_components; ++j)
-          component_mapping.push_back(this->get_mapped_mask(ids[i])[j]);
-
-      VectorTools::project_boundary_values(
-        dof_handler, boundary_map, quadrature, projected_bv, component_mapping);
-    }
+  project_boundary_values(StaticMappingQ1<dim, spacedim>::mapping,
+                          dof_handler,
+                          quadrature,
+                          projected_bv);
 }
 
 
@@ -20,10 +20,19 @@
 #include <deal.II/grid/grid_out.h>
 #include <deal.II/grid/grid_tools.h>
 #include <deal.II/grid/manifold_lib.h>
+#include <deal.II/grid/tria_description.h>
 
 #include <deal.II/opencascade/boundary_lib.h>
 #include <deal.II/opencascade/utilities.h>
 
+#ifdef DEAL_II_WITH_OPENCASCADE
+#  include <BRepBndLib.hxx>
+#  include <BRepTools.hxx>
+#  include <BRep_Builder.hxx>
+#  include <Bnd_Box.hxx>
+#  include <TopExp_Explorer.hxx>
+#endif
+
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
@@ -32,7 +41,16 @@
 #include <deal2lkit/parsed_grid_generator.h>
 #include <deal2lkit/utilities.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
 #include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
 #include <type_traits>
 
 namespace
@@ -51,6 +69,23 @@ namespace
         return "";
       }
   }
+
+  /**
+   * 64 bit FNV-1a hash of a string. Contrary to std::hash, the result
+   * does not depend on the standard library, so that it can be used in
+   * file names that are shared among different executables.
+   */
+  std::uint64_t
+  fnv1a_hash(const std::string &str)
+  {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (const char c : str)
+      {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+      }
+    return hash;
+  }
 } // namespace
 
 using namespace dealii;
@@ -93,6 +128,7 @@ ParsedGridGenerator<dim, spacedim>::ParsedGridGenerator(
   , str_un_int_1(_int_1)
   , str_un_int_2(_int_2)
   , str_vec_int(_vec_of_int)
+  , mpi_communicator(MPI_COMM_SELF)
 {}
 
 
@@ -375,33 +411,72 @@ ParsedGridGenerator<dim, spacedim>::declare_parameters(ParameterHandler &prm)
                 "Name of the output grid. All supported deal.II formats. "
                 "The extestion will be used to decide what "
                 "grid format to use. If empty, no grid will be written.");
-}
 
-#ifdef DEAL_II_WITH_MPI
-#  ifdef DEAL_II_WITH_P4EST
-template <int dim, int spacedim>
-std::unique_ptr<dealii::parallel::distributed::Triangulation<dim, spacedim>>
-ParsedGridGenerator<dim, spacedim>::distributed(MPI_Comm comm)
-{
-  Assert(grid_name != "", ExcNotInitialized());
-  auto tria = std::make_unique<
-    dealii::parallel::distributed::Triangulation<dim, spacedim>>(
-    comm); //, get_smoothing());
-
-  create(*tria);
-  return tria;
+  add_parameter(prm,
+                &cache_directory,
+                "Triangulation cache directory",
+                cache_directory,
+                Patterns::DirectoryName(),
+                "If not empty, the triangulations created and refined by "
+                "serial() are saved in this directory, and loaded from it "
+                "when the same grid with the same number of refinements is "
+                "requested again.");
 }
-#  endif
-#endif
-
 
 template <int dim, int spacedim>
 std::unique_ptr<dealii::Triangulation<dim, spacedim>>
-ParsedGridGenerator<dim, spacedim>::serial()
+ParsedGridGenerator<dim, spacedim>::serial(const unsigned int n_refinements,
+                                           MPI_Comm           comm)
 {
   Assert(grid_name != "", ExcNotInitialized());
   auto tria = std::make_unique<Triangulation<dim, spacedim>>(get_smoothing());
-  create(*tria);
+
+  // The first process of comm decides if the cache can be used, and is
+  // the only one writing it.
+  const std::string cache_file = cache_file_name("tria", n_refinements, comm);
+
+  const bool is_root   = (Utilities::MPI::this_mpi_process(comm) == 0);
+  int        cache_hit = 0;
+  if (cache_file != "" && is_root)
+    cache_hit = file_exists(cache_file);
+#ifdef DEAL_II_WITH_MPI
+  if (Utilities::MPI::n_mpi_processes(comm) > 1)
+    MPI_Bcast(&cache_hit, 1, MPI_INT, 0, comm);
+#endif
+
+  if (cache_hit)
+    {
+      std::ifstream in(cache_file.c_str());
+      AssertThrow(in, ExcIO());
+      boost::archive::binary_iarchive ia(in);
+      tria->load(ia, 0);
+      set_manifolds(*tria);
+    }
+  else
+    {
+      create(*tria);
+      tria->refine_global(n_refinements);
+      if (cache_file != "" && is_root)
+        {
+          // Write to a temporary file first, so that an interrupted run
+          // does not leave a corrupted cache behind. The name of the
+          // temporary file is unique, in case other programs (or other
+          // processes which did not pass their communicator) write the
+          // same grid at the same time.
+          const std::string tmp_file =
+            cache_file + ".tmp" +
+            Utilities::int_to_string(
+              Utilities::MPI::this_mpi_process(MPI_COMM_WORLD));
+          create_directory(cache_directory);
+          {
+            std::ofstream out(tmp_file.c_str());
+            AssertThrow(out, ExcIO());
+            boost::archive::binary_oarchive oa(out);
+            tria->save(oa, 0);
+          }
+          rename_file(tmp_file, cache_file);
+        }
+    }
   return tria;
 }
 
@@ -431,6 +506,112 @@ namespace Manifolds
   template <int dim, int spacedim>
   using NormalToMeshProjection = NormalToMeshProjectionBoundary<dim, spacedim>;
 #  endif
+
+#  if DEAL_II_VERSION_GTE(9, 1, 0)
+  /**
+   * A NormalProjection manifold which looks for the closest point of the
+   * shape only on the faces (or, if there are no faces, on the edges)
+   * whose bounding box may contain it, instead of projecting on all of
+   * them. The bounding boxes are computed once, and shared by all the
+   * clones of the manifold.
+   */
+  template <int dim, int spacedim>
+  class IndexedNormalProjection : public NormalProjection<dim, spacedim>
+  {
+  public:
+    IndexedNormalProjection(const TopoDS_Shape &sh,
+                            const double        tolerance = 1e-7)
+      : NormalProjection<dim, spacedim>(sh, tolerance)
+      , tolerance(tolerance)
+    {
+      auto boxes = std::make_shared<std::vector<SubShape>>();
+      for (TopExp_Explorer exp(sh, TopAbs_FACE); exp.More(); exp.Next())
+        boxes->push_back(SubShape(exp.Current()));
+      if (boxes->empty())
+        for (TopExp_Explorer exp(sh, TopAbs_EDGE); exp.More(); exp.Next())
+          boxes->push_back(SubShape(exp.Current()));
+      sub_shapes = boxes;
+    }
+
+    virtual std::unique_ptr<Manifold<dim, spacedim>>
+    clone() const override
+    {
+      return std::make_unique<IndexedNormalProjection<dim, spacedim>>(*this);
+    }
+
+    virtual Point<spacedim>
+    project_to_manifold(const ArrayView<const Point<spacedim>> &,
+                        const Point<spacedim> &candidate) const override
+    {
+      // Visit the sub-shapes by increasing distance of their bounding
+      // box, and stop when no box can contain a closer point.
+      std::vector<std::pair<double, unsigned int>> order;
+      order.reserve(sub_shapes->size());
+      for (unsigned int i = 0; i < sub_shapes->size(); ++i)
+        order.emplace_back((*sub_shapes)[i].distance(candidate), i);
+      std::sort(order.begin(), order.end());
+
+      Point<spacedim> best          = candidate;
+      double          best_distance = std::numeric_limits<double>::max();
+      for (const auto &o : order)
+        {
+          if (o.first > best_distance)
+            break;
+          const Point<spacedim> p = closest_point(
+            (*sub_shapes)[o.second].shape, candidate, tolerance);
+          const double d = p.distance(candidate);
+          if (d < best_distance)
+            {
+              best          = p;
+              best_distance = d;
+            }
+        }
+      return best;
+    }
+
+  private:
+    /**
+     * A face or an edge of the shape, with its bounding box.
+     */
+    struct SubShape
+    {
+      SubShape(const TopoDS_Shape &shape)
+        : shape(shape)
+      {
+        Bnd_Box box;
+        BRepBndLib::Add(shape, box);
+        box.Get(min[0], min[1], min[2], max[0], max[1], max[2]);
+      }
+
+      /**
+       * Lower bound of the distance of @p p from the sub-shape.
+       */
+      double
+      distance(const Point<spacedim> &p) const
+      {
+        double d2 = 0;
+        for (unsigned int d = 0; d < 3; ++d)
+          {
+            const double x   = (d < spacedim ? p[d] : 0.0);
+            const double gap = std::max({min[d] - x, x - max[d], 0.0});
+            d2 += gap * gap;
+          }
+        return std::sqrt(d2);
+      }
+
+      TopoDS_Shape shape;
+      double       min[3];
+      double       max[3];
+    };
+
+    std::shared_ptr<const std::vector<SubShape>> sub_shapes;
+
+    const double tolerance;
+  };
+#  else
+  template <int dim, int spacedim>
+  using IndexedNormalProjection = NormalProjection<dim, spacedim>;
+#  endif
 } // namespace Manifolds
 #endif
 
@@ -715,7 +896,9 @@ struct PGGHelper
         if (ext == "step" || ext == "stp" || ext == "iges" || ext == "igs")
           {
             TopoDS_Shape sh =
-              PGGHelper::readOCC(p->input_grid_file_name, p->double_option_one);
+              PGGHelper::readOCC(p,
+                                 p->input_grid_file_name,
+                                 p->double_option_one);
 
 
             std::vector<TopoDS_Face>   faces;
@@ -782,28 +965,29 @@ struct PGGHelper
             AssertDimension(subnames.size(), 2);
             return std::make_shared<
               OpenCASCADE::ArclengthProjectionLineManifold<dim, spacedim>>(
-              PGGHelper::readOCC(subnames[1], p->double_option_one));
+              PGGHelper::readOCC(p, subnames[1], p->double_option_one));
           }
         else if (subnames[0] == "DirectionalProjectionManifold")
           {
             AssertDimension(subnames.size(), 2);
             return std::make_shared<
               Manifolds::DirectionalProjection<dim, spacedim>>(
-              PGGHelper::readOCC(subnames[1], p->double_option_one),
+              PGGHelper::readOCC(p, subnames[1], p->double_option_one),
               (Tensor<1, spacedim>)p->point_option_one);
           }
         else if (subnames[0] == "NormalProjectionManifold")
           {
             AssertDimension(subnames.size(), 2);
-            return std::make_shared<Manifolds::NormalProjection<dim, spacedim>>(
-              PGGHelper::readOCC(subnames[1], p->double_option_one));
+            return std::make_shared<
+              Manifolds::IndexedNormalProjection<dim, spacedim>>(
+              PGGHelper::readOCC(p, subnames[1], p->double_option_one));
           }
         else if (subnames[0] == "NormalToMeshProjectionManifold")
           {
             AssertDimension(subnames.size(), 2);
             return std::make_shared<
               Manifolds::NormalToMeshProjection<dim, spacedim>>(
-              PGGHelper::readOCC(subnames[1], p->double_option_one));
+              PGGHelper::readOCC(p, subnames[1], p->double_option_one));
           }
 #endif
 
@@ -831,28 +1015,29 @@ struct PGGHelper
             AssertDimension(subnames.size(), 2);
             return std::make_shared<
               OpenCASCADE::ArclengthProjectionLineManifold<dim, spacedim>>(
-              PGGHelper::readOCC(subnames[1], p->double_option_one));
+              PGGHelper::readOCC(p, subnames[1], p->double_option_one));
           }
         else if (subnames[0] == "DirectionalProjectionManifold")
           {
             AssertDimension(subnames.size(), 2);
             return std::make_shared<
               Manifolds::DirectionalProjection<dim, spacedim>>(
-              PGGHelper::readOCC(subnames[1], p->double_option_one),
+              PGGHelper::readOCC(p, subnames[1], p->double_option_one),
               (Tensor<1, spacedim>)p->point_option_one);
           }
         else if (subnames[0] == "NormalProjectionManifold")
           {
             AssertDimension(subnames.size(), 2);
-            return std::make_shared<Manifolds::NormalProjection<dim, spacedim>>(
-              PGGHelper::readOCC(subnames[1], p->double_option_one));
+            return std::make_shared<
+              Manifolds::IndexedNormalProjection<dim, spacedim>>(
+              PGGHelper::readOCC(p, subnames[1], p->double_option_one));
           }
         else if (subnames[0] == "NormalToMeshProjectionManifold")
           {
             AssertDimension(subnames.size(), 2);
             return std::make_shared<
               Manifolds::NormalToMeshProjection<dim, spacedim>>(
-              PGGHelper::readOCC(subnames[1], p->double_option_one));
+              PGGHelper::readOCC(p, subnames[1], p->double_option_one));
           }
 #endif
         return default_create_manifold(p, name);
@@ -889,16 +1074,115 @@ struct PGGHelper
   }
 
 #ifdef DEAL_II_WITH_OPENCASCADE
+  /**
+   * Return the CAD shape stored in the file @p name, scaled by @p scale.
+   * Shapes are cached, so that every file is read only once for each
+   * scale, even if it is used by several manifold descriptors.
+   *
+   * This function is collective on the communicator of @p p: the file is
+   * read on its first process only, and the shape is sent to the other
+   * ones.
+   */
+  template <int dim, int spacedim>
+  static TopoDS_Shape
+  readOCC(const ParsedGridGenerator<dim, spacedim> *p,
+          const std::string &                       name,
+          const double &                            scale)
+  {
+    static std::map<std::pair<std::string, double>, TopoDS_Shape> cache;
+    static std::mutex                                             cache_mutex;
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    const auto key    = std::make_pair(name, scale);
+    bool       cached = (cache.find(key) != cache.end());
+#  ifdef DEAL_II_WITH_MPI
+    // All processes must take part in the broadcast, or none of them.
+    if (Utilities::MPI::n_mpi_processes(p->mpi_communicator) > 1)
+      cached =
+        (Utilities::MPI::min(cached ? 1 : 0, p->mpi_communicator) == 1);
+#  endif
+    if (!cached)
+      cache[key] = read_and_broadcast_OCC(name, scale, p->mpi_communicator);
+    return cache[key];
+  }
+
+  /**
+   * Read the CAD file @p name on the first process of @p comm, and send
+   * the shape to the other processes in the BRep format. If the file
+   * can not be read, an exception is thrown on all the processes.
+   */
   static TopoDS_Shape
-  readOCC(const std::string &name, const double &scale)
+  read_and_broadcast_OCC(const std::string &name,
+                         const double &     scale,
+                         MPI_Comm           comm)
   {
-    std::string  ext = extension(name);
-    TopoDS_Shape shape;
+    const bool is_root   = (Utilities::MPI::this_mpi_process(comm) == 0);
+    const bool broadcast = (Utilities::MPI::n_mpi_processes(comm) > 1);
+
+    TopoDS_Shape       shape;
+    std::string        buffer;
+    std::exception_ptr exc;
+    if (is_root)
+      {
+        try
+          {
+            const std::string ext = extension(name);
+            if (ext == "iges" || ext == "igs")
+              shape = OpenCASCADE::read_IGES(name, scale);
+            else if (ext == "step" || ext == "stp")
+              shape = OpenCASCADE::read_STEP(name, scale);
+            else
+              AssertThrow(false,
+                          ExcMessage("Unknown extension of the CAD file " +
+                                     name + ": use iges, igs, step or stp."));
+
+            if (broadcast)
+              {
+                std::ostringstream out;
+                BRepTools::Write(shape, out);
+                buffer = out.str();
+              }
+          }
+        catch (...)
+          {
+            exc = std::current_exception();
+          }
+      }
 
-    if (ext == "iges" || ext == "igs")
-      shape = OpenCASCADE::read_IGES(name, scale);
-    else if (ext == "step" || ext == "stp")
-      shape = OpenCASCADE::read_STEP(name, scale);
+#  ifdef DEAL_II_WITH_MPI
+    if (broadcast)
+      {
+        // Size of the buffer, and whether the root failed to read the
+        // file. Any failure must be known by all processes before they
+        // wait for the buffer.
+        unsigned long long sizes[2] = {buffer.size(), exc ? 1ull : 0ull};
+        MPI_Bcast(sizes, 2, MPI_UNSIGNED_LONG_LONG, 0, comm);
+        if (exc)
+          std::rethrow_exception(exc);
+        AssertThrow(sizes[1] == 0,
+                    ExcMessage("Could not read the CAD file " + name));
+
+        // The count of MPI_Bcast is an int: send large shapes in chunks.
+        const unsigned long long chunk = std::numeric_limits<int>::max();
+        buffer.resize(sizes[0]);
+        for (unsigned long long begin = 0; begin < sizes[0]; begin += chunk)
+          MPI_Bcast(&buffer[begin],
+                    static_cast<int>(std::min(chunk, sizes[0] - begin)),
+                    MPI_CHAR,
+                    0,
+                    comm);
+
+        if (!is_root)
+          {
+            std::istringstream in(buffer);
+            BRep_Builder       builder;
+            BRepTools::Read(shape, in, builder);
+          }
+      }
+#  endif
+    if (exc)
+      std::rethrow_exception(exc);
     return shape;
   }
 #endif
@@ -988,6 +1272,128 @@ struct PGGHelper
       }
     return shared_ptr<Manifold<dim, spacedim>>();
   }
+
+  /**
+   * Store the coarse mesh of @p tria in two flat buffers, that can be
+   * sent over MPI. The first one contains the coordinates of the
+   * vertices. The second one contains the number of cells, followed by
+   * the vertices, the material id and the manifold id of each cell, and
+   * then by the boundary faces (and, in 3d, the boundary lines) as well
+   * as by the interior faces and lines with a manifold id. Each of these
+   * is stored as its number of vertices, its vertices, its boundary id
+   * and its manifold id.
+   */
+  template <int dim, int spacedim>
+  static void
+  pack_coarse_mesh(const Triangulation<dim, spacedim> &tria,
+                   std::vector<double> &               coordinates,
+                   std::vector<unsigned int> &         connectivity)
+  {
+    for (const auto &v : tria.get_vertices())
+      for (unsigned int d = 0; d < spacedim; ++d)
+        coordinates.push_back(v[d]);
+
+    connectivity.push_back(tria.n_active_cells());
+    for (const auto &cell : tria.active_cell_iterators())
+      {
+        for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+          connectivity.push_back(cell->vertex_index(v));
+        connectivity.push_back(cell->material_id());
+        connectivity.push_back(cell->manifold_id());
+      }
+
+    std::vector<bool> face_done(tria.n_raw_faces(), false);
+    std::vector<bool> line_done(tria.n_raw_lines(), false);
+    for (const auto &cell : tria.active_cell_iterators())
+      {
+        for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell; ++f)
+          {
+            const auto face = cell->face(f);
+            if (face_done[face->index()] ||
+                (!face->at_boundary() &&
+                 face->manifold_id() == numbers::flat_manifold_id))
+              continue;
+            face_done[face->index()] = true;
+
+            connectivity.push_back(GeometryInfo<dim>::vertices_per_face);
+            for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_face;
+                 ++v)
+              connectivity.push_back(face->vertex_index(v));
+            connectivity.push_back(face->boundary_id());
+            connectivity.push_back(face->manifold_id());
+          }
+
+        if (dim == 3)
+          for (unsigned int l = 0; l < GeometryInfo<dim>::lines_per_cell; ++l)
+            {
+              const auto line = cell->line(l);
+              if (line_done[line->index()] ||
+                  ((!line->at_boundary() || line->boundary_id() == 0) &&
+                   line->manifold_id() == numbers::flat_manifold_id))
+                continue;
+              line_done[line->index()] = true;
+
+              connectivity.push_back(2);
+              connectivity.push_back(line->vertex_index(0));
+              connectivity.push_back(line->vertex_index(1));
+              connectivity.push_back(line->boundary_id());
+              connectivity.push_back(line->manifold_id());
+            }
+      }
+  }
+
+  /**
+   * Create @p tria from the buffers filled by pack_coarse_mesh().
+   */
+  template <int dim, int spacedim>
+  static void
+  unpack_coarse_mesh(const std::vector<double> &      coordinates,
+                     const std::vector<unsigned int> &connectivity,
+                     Triangulation<dim, spacedim> &   tria)
+  {
+    std::vector<Point<spacedim>> vertices(coordinates.size() / spacedim);
+    for (unsigned int i = 0; i < vertices.size(); ++i)
+      for (unsigned int d = 0; d < spacedim; ++d)
+        vertices[i][d] = coordinates[i * spacedim + d];
+
+    auto it = connectivity.begin();
+
+    std::vector<CellData<dim>> cells(*it++);
+    for (auto &cell : cells)
+      {
+        for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+          cell.vertices[v] = *it++;
+        cell.material_id = *it++;
+        cell.manifold_id = *it++;
+      }
+
+    SubCellData subcell_data;
+    while (it != connectivity.end())
+      {
+        const unsigned int n_vertices = *it++;
+        if (n_vertices == 2)
+          {
+            CellData<1> line;
+            line.vertices[0] = *it++;
+            line.vertices[1] = *it++;
+            line.boundary_id = *it++;
+            line.manifold_id = *it++;
+            subcell_data.boundary_lines.push_back(line);
+          }
+        else
+          {
+            AssertDimension(n_vertices, 4);
+            CellData<2> quad;
+            for (unsigned int v = 0; v < 4; ++v)
+              quad.vertices[v] = *it++;
+            quad.boundary_id = *it++;
+            quad.manifold_id = *it++;
+            subcell_data.boundary_quads.push_back(quad);
+          }
+      }
+
+    tria.create_triangulation(vertices, cells, subcell_data);
+  }
 };
 
 
@@ -998,7 +1404,16 @@ ParsedGridGenerator<dim, spacedim>::create(Triangulation<dim, spacedim> &tria)
 {
   Assert(grid_name != "", ExcNotInitialized());
   PGGHelper::create_grid(this, tria);
+  attach_manifolds(tria);
+}
+
 
+
+template <int dim, int spacedim>
+void
+ParsedGridGenerator<dim, spacedim>::attach_manifolds(
+  Triangulation<dim, spacedim> &tria)
+{
   if (!(dim == 1 && spacedim == 3))
     {
       parse_manifold_descriptors(optional_manifold_descriptors);
@@ -1017,6 +1432,246 @@ ParsedGridGenerator<dim, spacedim>::create(Triangulation<dim, spacedim> &tria)
     }
 }
 
+
+
+template <int dim, int spacedim>
+void
+ParsedGridGenerator<dim, spacedim>::set_manifolds(
+  Triangulation<dim, spacedim> &tria)
+{
+  if (grid_name == "file")
+    {
+      if (!(dim == 1 && spacedim == 3))
+        {
+          parse_manifold_descriptors(optional_manifold_descriptors);
+          for (auto m : manifold_descriptors)
+            tria.set_manifold(m.first, *m.second);
+        }
+    }
+  else
+    {
+      // Most GridGenerator functions attach their own manifolds: create
+      // the (cheap) coarse grid again to get them. A clone of a
+      // TransfiniteInterpolationManifold stays bound to the triangulation
+      // of the original, which is destroyed here, so it is created again
+      // on tria. The other manifolds do not refer to a triangulation.
+      Triangulation<dim, spacedim> coarse_tria;
+      create(coarse_tria);
+      for (const auto id : coarse_tria.get_manifold_ids())
+        if (id != numbers::flat_manifold_id)
+          {
+            if (dynamic_cast<
+                  const TransfiniteInterpolationManifold<dim, spacedim> *>(
+                  &coarse_tria.get_manifold(id)) != nullptr)
+              {
+                TransfiniteInterpolationManifold<dim, spacedim> manifold;
+                manifold.initialize(tria);
+                tria.set_manifold(id, manifold);
+              }
+            else
+              tria.set_manifold(id, coarse_tria.get_manifold(id));
+          }
+    }
+}
+
+
+
+template <int dim, int spacedim>
+std::string
+ParsedGridGenerator<dim, spacedim>::cache_file_name(
+  const std::string &prefix,
+  const unsigned int n_refinements,
+  MPI_Comm           comm) const
+{
+  if (cache_directory == "")
+    return "";
+
+  // Only the first process reads the grid file and computes the hash.
+  std::uint64_t hash = 0;
+  if (Utilities::MPI::this_mpi_process(comm) == 0)
+    {
+      std::ostringstream key;
+      key << std::setprecision(17) << grid_name << '|' << mesh_smoothing
+          << '|' << input_grid_file_name << '|' << double_option_one << '|'
+          << double_option_two << '|' << double_option_three << '|'
+          << point_option_one << '|' << point_option_two << '|'
+          << un_int_option_one << '|' << un_int_option_two << '|';
+      for (const auto i : un_int_vec_option_one)
+        key << i << ',';
+      key << '|' << colorize << '|' << copy_boundary_to_manifold_ids << '|'
+          << copy_material_to_manifold_ids << '|' << create_default_manifolds
+          << '|' << optional_manifold_descriptors << '|' << n_refinements;
+
+      // The same file name may refer to a different grid, or to a
+      // different CAD geometry used by the manifold descriptors.
+      if (grid_name == "file")
+        {
+          std::ifstream in(input_grid_file_name.c_str());
+          if (in)
+            key << '|' << in.rdbuf();
+        }
+      for (const auto &descriptor :
+           Utilities::split_string_list(optional_manifold_descriptors, '%'))
+        for (const auto &field : Utilities::split_string_list(descriptor, ':'))
+          {
+            const std::string ext = extension(field);
+            if (ext == "iges" || ext == "igs" || ext == "step" || ext == "stp")
+              {
+                std::ifstream in(field.c_str());
+                if (in)
+                  key << '|' << in.rdbuf();
+              }
+          }
+      hash = fnv1a_hash(key.str());
+    }
+#ifdef DEAL_II_WITH_MPI
+  if (Utilities::MPI::n_mpi_processes(comm) > 1)
+    MPI_Bcast(&hash, 1, MPI_UINT64_T, 0, comm);
+#endif
+
+  std::ostringstream name;
+  name << cache_directory << "/" << prefix << "_" << dim << spacedim << "_"
+       << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return name.str();
+}
+
+
+#ifdef DEAL_II_WITH_MPI
+#  ifdef DEAL_II_WITH_P4EST
+template <int dim, int spacedim>
+std::unique_ptr<dealii::parallel::distributed::Triangulation<dim, spacedim>>
+ParsedGridGenerator<dim, spacedim>::distributed(
+  MPI_Comm           comm,
+  const unsigned int n_refinements)
+{
+  Assert(grid_name != "", ExcNotInitialized());
+  auto tria = std::make_unique<
+    dealii::parallel::distributed::Triangulation<dim, spacedim>>(
+    comm); //, get_smoothing());
+
+  // CAD files used by the manifold descriptors are read on the first
+  // process only.
+  mpi_communicator = comm;
+
+  if (create_from_file_on_root(*tria, comm))
+    attach_manifolds(*tria);
+  else
+    create(*tria);
+
+  tria->refine_global(n_refinements);
+
+  mpi_communicator = MPI_COMM_SELF;
+  return tria;
+}
+#  endif
+
+
+
+template <int dim, int spacedim>
+std::unique_ptr<
+  dealii::parallel::fullydistributed::Triangulation<dim, spacedim>>
+ParsedGridGenerator<dim, spacedim>::fully_distributed(
+  MPI_Comm           comm,
+  const unsigned int n_refinements)
+{
+  Assert(grid_name != "", ExcNotInitialized());
+  auto tria = std::make_unique<
+    dealii::parallel::fullydistributed::Triangulation<dim, spacedim>>(comm);
+
+  // Using a single group made of all the processes, the serial grid is
+  // only created on the first one.
+  const auto description = TriangulationDescription::Utilities::
+    create_description_from_triangulation_in_groups<dim, spacedim>(
+      [&](Triangulation<dim, spacedim> &serial_tria) {
+        create(serial_tria);
+        serial_tria.refine_global(n_refinements);
+      },
+      [](Triangulation<dim, spacedim> &serial_tria,
+         const MPI_Comm                group_comm,
+         const unsigned int) {
+        const unsigned int n_partitions =
+          Utilities::MPI::n_mpi_processes(group_comm);
+#  ifdef DEAL_II_WITH_METIS
+        GridTools::partition_triangulation(n_partitions, serial_tria);
+#  else
+        GridTools::partition_triangulation_zorder(n_partitions, serial_tria);
+#  endif
+      },
+      comm,
+      Utilities::MPI::n_mpi_processes(comm),
+      get_smoothing());
+
+  tria->create_triangulation(description);
+
+  // The manifold ids are part of the description, but the manifolds
+  // themselves must be attached on every process, once the cells exist.
+  // This time, CAD files can be read on the first process and sent to
+  // the others.
+  mpi_communicator = comm;
+  set_manifolds(*tria);
+  mpi_communicator = MPI_COMM_SELF;
+
+  return tria;
+}
+
+
+
+template <int dim, int spacedim>
+bool
+ParsedGridGenerator<dim, spacedim>::create_from_file_on_root(
+  Triangulation<dim, spacedim> &tria,
+  MPI_Comm                      comm)
+{
+  const std::string ext = extension(input_grid_file_name);
+  if (dim == 1 || grid_name != "file" ||
+      !(ext == "vtk" || ext == "msh" || ext == "ucd" || ext == "inp" ||
+        ext == "unv"))
+    return false;
+
+  const unsigned int root = 0;
+  const bool is_root      = Utilities::MPI::this_mpi_process(comm) == root;
+
+  std::vector<double>       coordinates;
+  std::vector<unsigned int> connectivity;
+  std::exception_ptr        exc;
+  if (is_root)
+    {
+      try
+        {
+          Triangulation<dim, spacedim> coarse_tria;
+          PGGHelper::create_grid(this, coarse_tria);
+          PGGHelper::pack_coarse_mesh(coarse_tria, coordinates, connectivity);
+        }
+      catch (...)
+        {
+          exc = std::current_exception();
+        }
+    }
+
+  // Sizes of the two buffers, and whether the root failed to read the
+  // file. Any failure must be known by all processes before they wait
+  // for the buffers.
+  unsigned long long sizes[3] = {coordinates.size(),
+                                 connectivity.size(),
+                                 exc ? 1ull : 0ull};
+  MPI_Bcast(sizes, 3, MPI_UNSIGNED_LONG_LONG, root, comm);
+  if (exc)
+    std::rethrow_exception(exc);
+  AssertThrow(sizes[2] == 0,
+              ExcMessage("Could not read the grid file " +
+                         input_grid_file_name));
+
+  coordinates.resize(sizes[0]);
+  connectivity.resize(sizes[1]);
+  MPI_Bcast(coordinates.data(), sizes[0], MPI_DOUBLE, root, comm);
+  MPI_Bcast(connectivity.data(), sizes[1], MPI_UNSIGNED, root, comm);
+
+  PGGHelper::unpack_coarse_mesh(coordinates, connectivity, tria);
+  return true;
+}
+#endif
+
+
 template <>
 void
 ParsedGridGenerator<1, 3>::parse_manifold_descriptors(const std::string &)
@@ -13,10 +13,50 @@
 //
 //-----------------------------------------------------------
 
+#include <deal2lkit/parsed_batch_function.h>
 #include <deal2lkit/parsed_mapped_functions.h>
 
+#include <cctype>
+
 using namespace dealii;
 
+namespace
+{
+  /**
+   * Return true if the variable @p name appears in @p expression, as a
+   * whole identifier.
+   */
+  bool
+  uses_variable(const std::string &expression, const std::string &name)
+  {
+    for (std::size_t i = 0; i < expression.size();)
+      if (std::isalpha(expression[i]) || expression[i] == '_')
+        {
+          std::size_t j = i + 1;
+          while (j < expression.size() &&
+                 (std::isalnum(expression[j]) || expression[j] == '_'))
+            ++j;
+          if (expression.compare(i, j - i, name) == 0 && j - i == name.size())
+            return true;
+          i = j;
+        }
+      else if (std::isdigit(expression[i]) || expression[i] == '.')
+        {
+          // Skip numbers, including the exponent of 1e-3.
+          std::size_t j = i + 1;
+          while (j < expression.size() &&
+                 (std::isalnum(expression[j]) || expression[j] == '.' ||
+                  ((expression[j] == '-' || expression[j] == '+') &&
+                   (expression[j - 1] == 'e' || expression[j - 1] == 'E'))))
+            ++j;
+          i = j;
+        }
+      else
+        ++i;
+    return false;
+  }
+} // namespace
+
 D2K_NAMESPACE_OPEN
 
 template <int spacedim>
@@ -167,6 +207,7 @@ ParsedMappedFunctions<spacedim>::split_id_functions(
   const std::string &constants)
 {
   std::vector<unsigned int> id_defined_functions;
+  time_dependent_ids.clear();
 
   // if it is empty a ZeroFunction<dim>(n_components) is applied on the
   // parsed ids in the components
@@ -175,13 +216,12 @@ ParsedMappedFunctions<spacedim>::split_id_functions(
       for (unsigned int i = 0; i < ids.size(); ++i)
         {
           id_defined_functions.push_back(ids[i]);
-          shared_ptr<dealii::Functions::ParsedFunction<spacedim>> ptr;
+          shared_ptr<ParsedBatchFunction<spacedim>> ptr;
 
           ParameterHandler internal_prm;
           dealii::Functions::ParsedFunction<spacedim>::declare_parameters(
             internal_prm, n_components);
-          ptr = std::make_shared<dealii::Functions::ParsedFunction<spacedim>>(
-            n_components);
+          ptr = std::make_shared<ParsedBatchFunction<spacedim>>(n_components);
           ptr->parse_parameters(internal_prm);
 
           id_functions[ids[i]] = ptr;
@@ -206,21 +246,22 @@ ParsedMappedFunctions<spacedim>::split_id_functions(
 
           unsigned int id      = Utilities::string_to_int(id_func[0]);
           id_str_functions[id] = id_func[1];
+          if (uses_variable(id_func[1], "t"))
+            time_dependent_ids.insert(id);
 
           // check if the current id is also defined in id_components
           AssertThrow((std::find(ids.begin(), ids.end(), id) != ids.end()),
                       ExcIdNotMatch(id));
           id_defined_functions.push_back(id);
 
-          shared_ptr<dealii::Functions::ParsedFunction<spacedim>> ptr;
+          shared_ptr<ParsedBatchFunction<spacedim>> ptr;
 
           ParameterHandler internal_prm;
           dealii::Functions::ParsedFunction<spacedim>::declare_parameters(
             internal_prm, n_components);
           internal_prm.set("Function expression", id_func[1]);
           internal_prm.set("Function constants", constants);
-          ptr = std::make_shared<dealii::Functions::ParsedFunction<spacedim>>(
-            n_components);
+          ptr = std::make_shared<ParsedBatchFunction<spacedim>>(n_components);
           ptr->parse_parameters(internal_prm);
 
           id_functions[id] = ptr;
@@ -348,6 +389,14 @@ ParsedMappedFunctions<spacedim>::acts_on_id(unsigned int &id) const
   return id_components.find(id) != id_components.end();
 }
 
+template <int spacedim>
+bool
+ParsedMappedFunctions<spacedim>::is_time_dependent(
+  const unsigned int &id) const
+{
+  return time_dependent_ids.find(id) != time_dependent_ids.end();
+}
+
 template <int spacedim>
 void
 ParsedMappedFunctions<spacedim>::set_time(const double &t)
@@ -380,7 +429,7 @@ ParsedMappedFunctions<spacedim>::set_normal_functions()
           std::vector<std::string> normal_func;
           normal_func =
             Utilities::split_string_list(id_str_functions[normal_ids[i]], ';');
-          shared_ptr<dealii::Functions::ParsedFunction<spacedim>> normal_ptr;
+          shared_ptr<ParsedBatchFunction<spacedim>> normal_ptr;
 
           ParameterHandler normal_prm;
           dealii::Functions::ParsedFunction<spacedim>::declare_parameters(
@@ -394,8 +443,7 @@ ParsedMappedFunctions<spacedim>::set_normal_functions()
           normal_prm.set("Function expression", str_normal_func);
           normal_prm.set("Function constants", str_constants);
           normal_ptr =
-            std::make_shared<dealii::Functions::ParsedFunction<spacedim>>(
-              spacedim);
+            std::make_shared<ParsedBatchFunction<spacedim>>(spacedim);
           normal_ptr->parse_parameters(normal_prm);
           std::pair<unsigned int, unsigned int> id_fcv(normal_ids[i], fcv);
           _normal_functions[id_fcv] = normal_ptr;
@@ -20,6 +20,10 @@
 
 #  include <deal.II/dofs/dof_tools.h>
 
+#  include <deal2lkit/parsed_preconditioner/rigid_body_modes.h>
+
+#  include <ml_MultiLevelPreconditioner.h>
+
 using namespace dealii;
 
 D2K_NAMESPACE_OPEN
@@ -45,11 +49,20 @@ ParsedAMGPreconditioner::ParsedAMGPreconditioner(
   , w_cycle(w_cycle)
   , aggregation_threshold(aggregation_threshold)
   , var_const_modes(var_const_modes)
+  , near_null_space("constant modes")
   , smoother_sweeps(smoother_sweeps)
   , smoother_overlap(smoother_overlap)
   , output_details(output_details)
   , smoother_type(smoother_type)
   , coarse_type(coarse_type)
+  , reuse_policy("rebuild always")
+  , max_iteration_growth(50.0)
+  , hierarchy_matrix(nullptr)
+  , hierarchy_n_rows(0)
+  , hierarchy_n_nonzeros(0)
+  , reference_iterations(0)
+  , rebuild_requested(false)
+  , last_initialization_reused(false)
 {}
 
 void
@@ -117,6 +130,18 @@ ParsedAMGPreconditioner::declare_parameters(ParameterHandler &prm)
     "is equal to \"none\", constant modes will not be\n"
     "computed.");
 
+  add_parameter(
+    prm,
+    &near_null_space,
+    "Near null space",
+    near_null_space,
+    Patterns::Selection("constant modes|rigid body modes"),
+    "Near null space used when the variable related to constant modes is a\n"
+    "vector. With \"rigid body modes\", the rotations computed from the\n"
+    "support points of the degrees of freedom are added to the\n"
+    "translations. This is the near null space of linear elasticity.\n"
+    "Scalar variables always use the constant mode.");
+
   add_parameter(
     prm,
     &smoother_sweeps,
@@ -181,12 +206,110 @@ ParsedAMGPreconditioner::declare_parameters(ParameterHandler &prm)
       "|IFPACK-Block Chebyshev"),
     "Determines which solver to use on the coarsest level. The same\n"
     "settings as for the smoother type are possible.");
+
+  add_parameter(
+    prm,
+    &reuse_policy,
+    "Hierarchy reuse policy",
+    reuse_policy,
+    Patterns::Selection(
+      "rebuild always|reuse aggregates|reuse until iteration growth"),
+    "Determines when the AMG hierarchy is rebuilt. With \"reuse\n"
+    "aggregates\", the aggregates and the prolongators are kept as long as\n"
+    "the preconditioner is initialized with the same matrix object, and\n"
+    "only the coarse operators, the smoothers and the coarse solver are\n"
+    "recomputed. \"reuse until iteration growth\" does the same, but\n"
+    "rebuilds the hierarchy when the number of iterations reported by the\n"
+    "user, or by a ParsedSolver through report_iterations_to(), grows by\n"
+    "more than the maximum iteration growth.");
+
+  add_parameter(prm,
+                &max_iteration_growth,
+                "Maximum iteration growth",
+                std::to_string(max_iteration_growth),
+                Patterns::Double(0.0),
+                "Maximum growth, in percent, of the number of iterations\n"
+                "before the hierarchy is rebuilt, with the \"reuse until\n"
+                "iteration growth\" policy.");
+}
+
+void
+ParsedAMGPreconditioner::report_iterations(const unsigned int n_iterations)
+{
+  if (reference_iterations == 0)
+    reference_iterations = n_iterations;
+  else if (reuse_policy == "reuse until iteration growth" &&
+           n_iterations >
+             reference_iterations * (1.0 + max_iteration_growth / 100.0))
+    rebuild_requested = true;
+}
+
+bool
+ParsedAMGPreconditioner::can_reuse_hierarchy(
+  const Epetra_RowMatrix &matrix) const
+{
+  // ML keeps a pointer to the matrix: the hierarchy can only be reused
+  // if the entries of the same matrix object have changed, and not its
+  // sparsity pattern.
+  return reuse_policy != "rebuild always" && !rebuild_requested &&
+         preconditioner.get() != nullptr && hierarchy_matrix == &matrix &&
+         hierarchy_n_rows == matrix.NumGlobalRows64() &&
+         hierarchy_n_nonzeros == matrix.NumGlobalNonzeros64();
+}
+
+bool
+ParsedAMGPreconditioner::reused_hierarchy() const
+{
+  return last_initialization_reused;
+}
+
+void
+ParsedAMGPreconditioner::recompute_hierarchy()
+{
+  auto ml = dynamic_cast<ML_Epetra::MultiLevelPreconditioner *>(
+    preconditioner.get());
+  Assert(ml != nullptr, ExcInternalError());
+  const int ierr = ml->ReComputePreconditioner();
+  AssertThrow(ierr == 0, ExcTrilinosError(ierr));
+  last_initialization_reused = true;
+}
+
+void
+ParsedAMGPreconditioner::build_hierarchy(
+  const Epetra_RowMatrix &                                 matrix,
+  const TrilinosWrappers::PreconditionAMG::AdditionalData &data)
+{
+  if (reuse_policy == "rebuild always")
+    this->initialize(matrix, data);
+  else
+    {
+      // The hierarchy can only be recomputed later if ML is told to keep
+      // the data it needs.
+      Teuchos::ParameterList              parameter_list;
+      std::unique_ptr<Epetra_MultiVector> distributed_constant_modes;
+      data.set_parameters(parameter_list, distributed_constant_modes, matrix);
+      parameter_list.set("reuse: enable", true);
+      this->initialize(matrix, parameter_list);
+    }
+
+  hierarchy_matrix           = &matrix;
+  hierarchy_n_rows           = matrix.NumGlobalRows64();
+  hierarchy_n_nonzeros       = matrix.NumGlobalNonzeros64();
+  reference_iterations       = 0;
+  rebuild_requested          = false;
+  last_initialization_reused = false;
 }
 
 template <typename Matrix>
 void
 ParsedAMGPreconditioner::initialize_preconditioner(const Matrix &matrix)
 {
+  if (can_reuse_hierarchy(matrix.trilinos_matrix()))
+    {
+      recompute_hierarchy();
+      return;
+    }
+
   TrilinosWrappers::PreconditionAMG::AdditionalData data;
 
   data.elliptic              = elliptic;
@@ -200,7 +323,7 @@ ParsedAMGPreconditioner::initialize_preconditioner(const Matrix &matrix)
   data.output_details        = output_details;
   data.smoother_type         = smoother_type.c_str();
   data.coarse_type           = coarse_type.c_str();
-  this->initialize(matrix, data);
+  build_hierarchy(matrix.trilinos_matrix(), data);
 }
 
 template <int dim, int spacedim, typename Matrix>
@@ -210,6 +333,12 @@ ParsedAMGPreconditioner::initialize_preconditioner(
   const ParsedFiniteElement<dim, spacedim> &fe,
   const DoFHandler<dim, spacedim> &         dh)
 {
+  if (can_reuse_hierarchy(matrix.trilinos_matrix()))
+    {
+      recompute_hierarchy();
+      return;
+    }
+
   TrilinosWrappers::PreconditionAMG::AdditionalData data;
 
   data.elliptic              = elliptic;
@@ -226,7 +355,13 @@ ParsedAMGPreconditioner::initialize_preconditioner(
       std::vector<std::vector<bool>> constant_modes;
       unsigned int pos    = fe.get_first_occurence(var_const_modes);
       bool         is_vec = fe.is_vector(var_const_modes);
-      if (is_vec)
+      if (is_vec && near_null_space == "rigid body modes")
+        {
+          FEValuesExtractors::Vector components(pos);
+          data.constant_modes_values = extract_rigid_body_modes(
+            dh, dh.get_fe().component_mask(components));
+        }
+      else if (is_vec)
         {
           FEValuesExtractors::Vector components(pos);
           DoFTools::extract_constant_modes(
@@ -245,7 +380,7 @@ ParsedAMGPreconditioner::initialize_preconditioner(
   data.output_details   = output_details;
   data.smoother_type    = smoother_type.c_str();
   data.coarse_type      = coarse_type.c_str();
-  this->initialize(matrix, data);
+  build_hierarchy(matrix.trilinos_matrix(), data);
 }
 
 D2K_NAMESPACE_CLOSE
@@ -21,6 +21,18 @@
 
 #  include <deal.II/dofs/dof_tools.h>
 
+#  include <deal2lkit/parsed_preconditioner/rigid_body_modes.h>
+
+#  include <Epetra_MpiComm.h>
+#  include <Epetra_MultiVector.h>
+#  include <MueLu_CreateEpetraPreconditioner.hpp>
+#  include <MueLu_EpetraOperator.hpp>
+#  include <MueLu_Hierarchy.hpp>
+#  include <MueLu_Level.hpp>
+#  include <MueLu_ML2MueLuParameterTranslator.hpp>
+#  include <Teuchos_XMLParameterListHelpers.hpp>
+#  include <Xpetra_Matrix.hpp>
+
 using namespace dealii;
 
 D2K_NAMESPACE_OPEN
@@ -44,11 +56,21 @@ ParsedAMGMueLuPreconditioner::ParsedAMGMueLuPreconditioner(
   , w_cycle(w_cycle)
   , aggregation_threshold(aggregation_threshold)
   , var_const_modes(var_const_modes)
+  , near_null_space("constant modes")
   , smoother_sweeps(smoother_sweeps)
   , smoother_overlap(smoother_overlap)
   , output_details(output_details)
   , smoother_type(smoother_type)
   , coarse_type(coarse_type)
+  , repartition(false)
+  , repartition_min_rows(800)
+  , repartition_max_imbalance(1.2)
+  , repartition_start_level(2)
+  , reuse_type("none")
+  , hierarchy_matrix(nullptr)
+  , hierarchy_n_rows(0)
+  , hierarchy_n_nonzeros(0)
+  , last_initialization_reused(false)
 {}
 
 void
@@ -107,6 +129,18 @@ ParsedAMGMueLuPreconditioner::declare_parameters(ParameterHandler &prm)
     "is equal to \"none\", constant modes will not be\n"
     "computed.");
 
+  add_parameter(
+    prm,
+    &near_null_space,
+    "Near null space",
+    near_null_space,
+    Patterns::Selection("constant modes|rigid body modes"),
+    "Near null space used when the variable related to constant modes is a\n"
+    "vector. With \"rigid body modes\", the rotations computed from the\n"
+    "support points of the degrees of freedom are added to the\n"
+    "translations. This is the near null space of linear elasticity.\n"
+    "Scalar variables always use the constant mode.");
+
   add_parameter(
     prm,
     &smoother_sweeps,
@@ -171,25 +205,191 @@ ParsedAMGMueLuPreconditioner::declare_parameters(ParameterHandler &prm)
       "|IFPACK-Block Chebyshev"),
     "Determines which solver to use on the coarsest level. The same\n"
     "settings as for the smoother type are possible.");
+
+  add_parameter(prm,
+                &repartition,
+                "Repartition",
+                repartition ? "true" : "false",
+                Patterns::Bool(),
+                "Rebalance the coarse levels across the processes, so that\n"
+                "the coarse solve does not involve many processes owning\n"
+                "only a handful of rows.");
+
+  add_parameter(prm,
+                &repartition_min_rows,
+                "Repartition minimum rows per process",
+                std::to_string(repartition_min_rows),
+                Patterns::Integer(1),
+                "Minimum number of rows per process on the coarse levels,\n"
+                "below which the level is repartitioned on fewer processes.");
+
+  add_parameter(prm,
+                &repartition_max_imbalance,
+                "Repartition maximum imbalance",
+                std::to_string(repartition_max_imbalance),
+                Patterns::Double(1.0),
+                "Maximum ratio between the largest and the average number of\n"
+                "rows per process on a coarse level, above which the level\n"
+                "is repartitioned.");
+
+  add_parameter(prm,
+                &repartition_start_level,
+                "Repartition start level",
+                std::to_string(repartition_start_level),
+                Patterns::Integer(1),
+                "First level on which repartitioning is considered.");
+
+  add_parameter(
+    prm,
+    &reuse_type,
+    "Reuse type",
+    reuse_type,
+    Patterns::Selection("none|tP|RP|full"),
+    "Which parts of the hierarchy are kept when the preconditioner is\n"
+    "initialized again with the same matrix object: \"none\" rebuilds the\n"
+    "hierarchy, \"tP\" keeps the tentative prolongators, \"RP\" the\n"
+    "smoothed prolongators and the restrictors, and \"full\" leaves the\n"
+    "whole hierarchy, smoothers included, untouched.");
 }
 
-template <typename Matrix>
 void
-ParsedAMGMueLuPreconditioner::initialize_preconditioner(const Matrix &matrix)
+ParsedAMGMueLuPreconditioner::set_ml_options(
+  TrilinosWrappers::PreconditionAMG::AdditionalData &data) const
 {
-  TrilinosWrappers::PreconditionAMGMueLu::AdditionalData data;
-
   data.elliptic              = elliptic;
   data.n_cycles              = n_cycles;
   data.w_cycle               = w_cycle;
   data.aggregation_threshold = aggregation_threshold;
-  data.constant_modes        = std::vector<std::vector<bool>>(0);
   data.smoother_sweeps       = smoother_sweeps;
   data.smoother_overlap      = smoother_overlap;
   data.output_details        = output_details;
   data.smoother_type         = smoother_type.c_str();
   data.coarse_type           = coarse_type.c_str();
-  this->initialize(matrix, data);
+}
+
+bool
+ParsedAMGMueLuPreconditioner::reuse_hierarchy(const Epetra_CrsMatrix &matrix)
+{
+  // MueLu keeps a pointer to the matrix: the hierarchy can only be set up
+  // again if the entries of the same matrix object have changed, and not
+  // its sparsity pattern.
+  if (reuse_type == "none" || hierarchy_matrix != &matrix ||
+      hierarchy_n_rows != matrix.NumGlobalRows64() ||
+      hierarchy_n_nonzeros != matrix.NumGlobalNonzeros64())
+    return false;
+
+  auto op = dynamic_cast<MueLu::EpetraOperator *>(preconditioner.get());
+  if (op == nullptr)
+    return false;
+
+  if (reuse_type != "full")
+    MueLu::ReuseEpetraPreconditioner(
+      Teuchos::rcp(const_cast<Epetra_CrsMatrix *>(&matrix), false), *op);
+  last_initialization_reused = true;
+  return true;
+}
+
+bool
+ParsedAMGMueLuPreconditioner::reused_hierarchy() const
+{
+  return last_initialization_reused;
+}
+
+std::vector<unsigned int>
+ParsedAMGMueLuPreconditioner::n_processes_per_level() const
+{
+  using LevelMatrix = Xpetra::Matrix<double, int, int, Xpetra::EpetraNode>;
+
+  auto op = dynamic_cast<const MueLu::EpetraOperator *>(preconditioner.get());
+  AssertThrow(op != nullptr && hierarchy_matrix != nullptr,
+              ExcNotInitialized());
+
+  const MPI_Comm comm =
+    dynamic_cast<const Epetra_MpiComm &>(hierarchy_matrix->Comm()).Comm();
+  const auto hierarchy = op->GetHierarchy();
+
+  // The processes that are left out by the repartitioning may have fewer
+  // levels.
+  const unsigned int n_local_levels = hierarchy->GetNumLevels();
+  const unsigned int n_levels       = Utilities::MPI::max(n_local_levels, comm);
+
+  std::vector<unsigned int> n_processes(n_levels);
+  for (unsigned int l = 0; l < n_levels; ++l)
+    {
+      unsigned int n_local_rows = 0;
+      if (l < n_local_levels)
+        {
+          const auto level = hierarchy->GetLevel(l);
+          if (level->IsAvailable("A"))
+            {
+              const auto A = level->Get<Teuchos::RCP<LevelMatrix>>("A");
+              if (!A.is_null())
+#  if DEAL_II_TRILINOS_VERSION_GTE(13, 4, 0)
+                n_local_rows = A->getRowMap()->getLocalNumElements();
+#  else
+                n_local_rows = A->getRowMap()->getNodeNumElements();
+#  endif
+            }
+        }
+      n_processes[l] = Utilities::MPI::sum(n_local_rows > 0 ? 1u : 0u, comm);
+    }
+  return n_processes;
+}
+
+void
+ParsedAMGMueLuPreconditioner::build_hierarchy(
+  const Epetra_CrsMatrix &                                 matrix,
+  const TrilinosWrappers::PreconditionAMG::AdditionalData &data)
+{
+  // The options exposed by this class are the ones of ML. Let deal.II
+  // write them as an ML parameter list, and MueLu translate it into its
+  // own syntax, which is the only one that knows about repartitioning
+  // and reuse.
+  Teuchos::ParameterList              ml_list;
+  std::unique_ptr<Epetra_MultiVector> distributed_modes;
+  data.set_parameters(ml_list, distributed_modes, matrix);
+
+  Teuchos::RCP<Teuchos::ParameterList> parameter_list =
+    Teuchos::getParametersFromXmlString(
+      MueLu::ML2MueLuParameterTranslator::translate(ml_list));
+
+  // The translation drops the pointer to the near null space: pass a
+  // copy of it as user data.
+  if (ml_list.isParameter("null space: vectors"))
+    parameter_list->sublist("user data")
+      .set("Nullspace",
+           Teuchos::rcp(new Epetra_MultiVector(*distributed_modes)));
+
+  parameter_list->set("repartition: enable", repartition);
+  if (repartition)
+    {
+      parameter_list->set("repartition: min rows per proc",
+                          static_cast<int>(repartition_min_rows));
+      parameter_list->set("repartition: max imbalance",
+                          repartition_max_imbalance);
+      parameter_list->set("repartition: start level",
+                          static_cast<int>(repartition_start_level));
+    }
+  parameter_list->set("reuse: type", reuse_type);
+
+  this->initialize(matrix, *parameter_list);
+  hierarchy_matrix           = &matrix;
+  hierarchy_n_rows           = matrix.NumGlobalRows64();
+  hierarchy_n_nonzeros       = matrix.NumGlobalNonzeros64();
+  last_initialization_reused = false;
+}
+
+template <typename Matrix>
+void
+ParsedAMGMueLuPreconditioner::initialize_preconditioner(const Matrix &matrix)
+{
+  if (reuse_hierarchy(matrix.trilinos_matrix()))
+    return;
+
+  TrilinosWrappers::PreconditionAMG::AdditionalData data;
+  set_ml_options(data);
+  data.constant_modes = std::vector<std::vector<bool>>(0);
+  build_hierarchy(matrix.trilinos_matrix(), data);
 }
 
 template <int dim, int spacedim, typename Matrix>
@@ -199,12 +399,11 @@ ParsedAMGMueLuPreconditioner::initialize_preconditioner(
   const ParsedFiniteElement<dim, spacedim> &fe,
   const DoFHandler<dim, spacedim> &         dh)
 {
-  TrilinosWrappers::PreconditionAMGMueLu::AdditionalData data;
+  if (reuse_hierarchy(matrix.trilinos_matrix()))
+    return;
 
-  data.elliptic              = elliptic;
-  data.n_cycles              = n_cycles;
-  data.w_cycle               = w_cycle;
-  data.aggregation_threshold = aggregation_threshold;
+  TrilinosWrappers::PreconditionAMG::AdditionalData data;
+  set_ml_options(data);
   if (var_const_modes == "none")
     {
       data.constant_modes = std::vector<std::vector<bool>>(0);
@@ -214,7 +413,13 @@ ParsedAMGMueLuPreconditioner::initialize_preconditioner(
       std::vector<std::vector<bool>> constant_modes;
       unsigned int pos    = fe.get_first_occurence(var_const_modes);
       bool         is_vec = fe.is_vector(var_const_modes);
-      if (is_vec)
+      if (is_vec && near_null_space == "rigid body modes")
+        {
+          FEValuesExtractors::Vector components(pos);
+          data.constant_modes_values = extract_rigid_body_modes(
+            dh, dh.get_fe().component_mask(components));
+        }
+      else if (is_vec)
         {
           FEValuesExtractors::Vector components(pos);
           DoFTools::extract_constant_modes(
@@ -228,12 +433,7 @@ ParsedAMGMueLuPreconditioner::initialize_preconditioner(
         }
       data.constant_modes = constant_modes;
     }
-  data.smoother_sweeps  = smoother_sweeps;
-  data.smoother_overlap = smoother_overlap;
-  data.output_details   = output_details;
-  data.smoother_type    = smoother_type.c_str();
-  data.coarse_type      = coarse_type.c_str();
-  this->initialize(matrix, data);
+  build_hierarchy(matrix.trilinos_matrix(), data);
 }
 
 D2K_NAMESPACE_CLOSE
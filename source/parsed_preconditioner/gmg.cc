@@ -0,0 +1,254 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/diagonal_matrix.h>
+
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <deal.II/multigrid/mg_coarse.h>
+
+#include <deal2lkit/parsed_preconditioner/gmg.h>
+
+using namespace dealii;
+
+D2K_NAMESPACE_OPEN
+
+template <int dim, typename VECTOR>
+ParsedGMGPreconditioner<dim, VECTOR>::ParsedGMGPreconditioner(
+  const std::string & name,
+  const unsigned int &smoother_degree,
+  const double &      smoothing_range,
+  const unsigned int &n_levels,
+  const std::string & coarse_solver,
+  const double &      coarse_reduction)
+  : ParameterAcceptor(name)
+  , smoother_degree(smoother_degree)
+  , smoothing_range(smoothing_range)
+  , n_levels(n_levels)
+  , coarse_solver(coarse_solver)
+  , coarse_reduction(coarse_reduction)
+{}
+
+template <int dim, typename VECTOR>
+void
+ParsedGMGPreconditioner<dim, VECTOR>::declare_parameters(ParameterHandler &prm)
+{
+  add_parameter(prm,
+                &smoother_degree,
+                "Smoother degree",
+                std::to_string(smoother_degree),
+                Patterns::Integer(1),
+                "Degree of the Chebyshev smoother, i.e., the number of\n"
+                "matrix-vector products performed on each level.");
+
+  add_parameter(prm,
+                &smoothing_range,
+                "Smoothing range",
+                std::to_string(smoothing_range),
+                Patterns::Double(1.0),
+                "Ratio between the largest eigenvalue of each level operator\n"
+                "and the smallest one damped by the Chebyshev smoother.");
+
+  add_parameter(prm,
+                &n_levels,
+                "Number of levels",
+                std::to_string(n_levels),
+                Patterns::Integer(0),
+                "Number of levels used by the multigrid cycle, counting from\n"
+                "the finest one. If zero, all the levels of the triangulation\n"
+                "are used.");
+
+  add_parameter(prm,
+                &coarse_solver,
+                "Coarse solver",
+                coarse_solver,
+                Patterns::Selection("chebyshev|cg"),
+                "Solver used on the coarsest level: \"chebyshev\" applies a\n"
+                "Chebyshev iteration with enough steps to act as a solver,\n"
+                "\"cg\" runs Jacobi preconditioned conjugate gradients up to\n"
+                "the coarse reduction.");
+
+  add_parameter(prm,
+                &coarse_reduction,
+                "Coarse reduction",
+                std::to_string(coarse_reduction),
+                Patterns::Double(0.0),
+                "Reduction of the residual required to the \"cg\" coarse\n"
+                "solver.");
+}
+
+template <int dim, typename VECTOR>
+void
+ParsedGMGPreconditioner<dim, VECTOR>::initialize_preconditioner(
+  const DoFHandler<dim> &             dof_handler,
+  const Mapping<dim> &                mapping,
+  const std::set<types::boundary_id> &dirichlet_ids,
+  const unsigned int                  n_q_points_1d)
+{
+  Assert(dof_handler.has_level_dofs(),
+         ExcMessage("The level degrees of freedom are not distributed: call "
+                    "DoFHandler::distribute_mg_dofs() first."));
+  AssertDimension(dof_handler.get_fe().n_components(), 1);
+
+  const unsigned int max_level =
+    dof_handler.get_triangulation().n_global_levels() - 1;
+  const unsigned int min_level =
+    (n_levels == 0 || n_levels > max_level) ? 0 : max_level + 1 - n_levels;
+
+  const QGauss<1> quadrature(n_q_points_1d > 0 ?
+                               n_q_points_1d :
+                               dof_handler.get_fe().degree + 1);
+
+  // Release everything that refers to the old level operators.
+  preconditioner.reset();
+  mg.reset();
+  mg_coarse.reset();
+  coarse_cg.reset();
+  coarse_control.reset();
+  mg_matrix.reset();
+  mg_smoother.clear();
+
+  mg_constrained_dofs.initialize(dof_handler);
+  mg_constrained_dofs.make_zero_boundary_constraints(dof_handler,
+                                                     dirichlet_ids);
+
+  mg_matrices.clear_elements();
+  mg_matrices.resize(min_level, max_level);
+  for (unsigned int level = min_level; level <= max_level; ++level)
+    {
+      AffineConstraints<double> level_constraints;
+      level_constraints.reinit(
+        DoFTools::extract_locally_relevant_level_dofs(dof_handler, level));
+      level_constraints.add_lines(
+        mg_constrained_dofs.get_boundary_indices(level));
+      level_constraints.close();
+
+      typename MatrixFree<dim, double>::AdditionalData additional_data;
+      additional_data.tasks_parallel_scheme =
+        MatrixFree<dim, double>::AdditionalData::none;
+      additional_data.mapping_update_flags =
+        update_gradients | update_JxW_values;
+      additional_data.mg_level = level;
+
+      auto matrix_free = std::make_shared<MatrixFree<dim, double>>();
+      matrix_free->reinit(
+        mapping, dof_handler, level_constraints, quadrature, additional_data);
+
+      mg_matrices[level].initialize(matrix_free, mg_constrained_dofs, level);
+      mg_matrices[level].compute_diagonal();
+    }
+
+  mg_transfer = std::make_unique<Transfer>();
+  mg_transfer->initialize_constraints(mg_constrained_dofs);
+  mg_transfer->build(dof_handler);
+
+  // On the coarsest level, the "chebyshev" coarse solver runs the
+  // smoother until convergence, so the eigenvalues are estimated on
+  // the whole spectrum.
+  MGLevelObject<typename Smoother::AdditionalData> smoother_data(min_level,
+                                                                 max_level);
+  for (unsigned int level = min_level; level <= max_level; ++level)
+    {
+      if (level == min_level && coarse_solver == "chebyshev")
+        {
+          smoother_data[level].smoothing_range = 1e-3;
+          smoother_data[level].degree = numbers::invalid_unsigned_int;
+          smoother_data[level].eig_cg_n_iterations = mg_matrices[level].m();
+        }
+      else
+        {
+          smoother_data[level].smoothing_range     = smoothing_range;
+          smoother_data[level].degree              = smoother_degree;
+          smoother_data[level].eig_cg_n_iterations = 10;
+        }
+      smoother_data[level].preconditioner =
+        mg_matrices[level].get_matrix_diagonal_inverse();
+    }
+  mg_smoother.initialize(mg_matrices, smoother_data);
+
+  if (coarse_solver == "chebyshev")
+    {
+      auto coarse = std::make_unique<MGCoarseGridApplySmoother<VECTOR>>();
+      coarse->initialize(mg_smoother);
+      mg_coarse = std::move(coarse);
+    }
+  else
+    {
+      coarse_control = std::make_unique<ReductionControl>(
+        mg_matrices[min_level].m(), 1e-14, coarse_reduction, false, false);
+      coarse_cg = std::make_unique<SolverCG<VECTOR>>(*coarse_control);
+      mg_coarse = std::make_unique<
+        MGCoarseGridIterativeSolver<VECTOR,
+                                    SolverCG<VECTOR>,
+                                    LevelMatrix,
+                                    DiagonalMatrix<VECTOR>>>(
+        *coarse_cg,
+        mg_matrices[min_level],
+        *mg_matrices[min_level].get_matrix_diagonal_inverse());
+    }
+
+  mg_matrix.initialize(mg_matrices);
+  mg = std::make_unique<Multigrid<VECTOR>>(mg_matrix,
+                                           *mg_coarse,
+                                           *mg_transfer,
+                                           mg_smoother,
+                                           mg_smoother,
+                                           min_level,
+                                           max_level);
+  preconditioner =
+    std::make_unique<PreconditionMG<dim, VECTOR, Transfer>>(dof_handler,
+                                                            *mg,
+                                                            *mg_transfer);
+}
+
+template <int dim, typename VECTOR>
+void
+ParsedGMGPreconditioner<dim, VECTOR>::vmult(VECTOR &      dst,
+                                            const VECTOR &src) const
+{
+  Assert(preconditioner, ExcNotInitialized());
+  preconditioner->vmult(dst, src);
+}
+
+template <int dim, typename VECTOR>
+void
+ParsedGMGPreconditioner<dim, VECTOR>::Tvmult(VECTOR &      dst,
+                                             const VECTOR &src) const
+{
+  vmult(dst, src);
+}
+
+template <int dim, typename VECTOR>
+const typename ParsedGMGPreconditioner<dim, VECTOR>::LevelMatrix &
+ParsedGMGPreconditioner<dim, VECTOR>::get_level_matrix(
+  const unsigned int level) const
+{
+  Assert(level >= mg_matrices.min_level() && level <= mg_matrices.max_level(),
+         ExcIndexRange(level,
+                       mg_matrices.min_level(),
+                       mg_matrices.max_level() + 1));
+  return mg_matrices[level];
+}
+
+D2K_NAMESPACE_CLOSE
+
+template class deal2lkit::ParsedGMGPreconditioner<1>;
+template class deal2lkit::ParsedGMGPreconditioner<2>;
+template class deal2lkit::ParsedGMGPreconditioner<3>;
@@ -0,0 +1,122 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/quadrature.h>
+
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_values.h>
+
+#include <deal2lkit/parsed_preconditioner/rigid_body_modes.h>
+
+using namespace dealii;
+
+D2K_NAMESPACE_OPEN
+
+template <int dim, int spacedim>
+std::vector<std::vector<double>>
+extract_rigid_body_modes(const DoFHandler<dim, spacedim> &dh,
+                         const ComponentMask &            component_mask,
+                         const Mapping<dim, spacedim> &   mapping)
+{
+  const FiniteElement<dim, spacedim> &fe = dh.get_fe();
+
+  AssertDimension(component_mask.n_selected_components(fe.n_components()),
+                  spacedim);
+  Assert(fe.is_primitive(),
+         ExcMessage("Rigid body modes need a primitive finite element."));
+  Assert(fe.has_support_points(),
+         ExcMessage("Rigid body modes need a finite element with support "
+                    "points."));
+
+  const unsigned int first_component =
+    component_mask.first_selected_component(fe.n_components());
+  const unsigned int n_modes = spacedim + spacedim * (spacedim - 1) / 2;
+  const IndexSet &   owned   = dh.locally_owned_dofs();
+
+  std::vector<std::vector<double>> modes(
+    n_modes, std::vector<double>(owned.n_elements(), 0.0));
+
+  // The support points of a cell are the quadrature points of a formula
+  // built on the unit support points.
+  const Quadrature<dim>   support_points(fe.get_unit_support_points());
+  FEValues<dim, spacedim> fe_values(mapping,
+                                    fe,
+                                    support_points,
+                                    update_quadrature_points);
+
+  std::vector<types::global_dof_index> dof_indices(fe.dofs_per_cell);
+
+  for (const auto &cell : dh.active_cell_iterators())
+    if (cell->is_locally_owned())
+      {
+        fe_values.reinit(cell);
+        cell->get_dof_indices(dof_indices);
+
+        for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+          {
+            const unsigned int c = fe.system_to_component_index(i).first;
+            if (!component_mask[c] || !owned.is_element(dof_indices[i]))
+              continue;
+
+            const unsigned int d = c - first_component;
+            const unsigned int index =
+              owned.index_within_set(dof_indices[i]);
+            const Point<spacedim> &x = fe_values.quadrature_point(i);
+
+            // Translation along the d-th direction.
+            modes[d][index] = 1.0;
+
+            // Rotation in the plane of the directions a and b, i.e., the
+            // displacement field (-x_b, x_a).
+            unsigned int mode = spacedim;
+            for (unsigned int a = 0; a < spacedim; ++a)
+              for (unsigned int b = a + 1; b < spacedim; ++b, ++mode)
+                if (d == a)
+                  modes[mode][index] = -x[b];
+                else if (d == b)
+                  modes[mode][index] = x[a];
+          }
+      }
+
+  return modes;
+}
+
+D2K_NAMESPACE_CLOSE
+
+template std::vector<std::vector<double>>
+deal2lkit::extract_rigid_body_modes(const DoFHandler<1, 1> &,
+                                    const ComponentMask &,
+                                    const Mapping<1, 1> &);
+template std::vector<std::vector<double>>
+deal2lkit::extract_rigid_body_modes(const DoFHandler<1, 2> &,
+                                    const ComponentMask &,
+                                    const Mapping<1, 2> &);
+template std::vector<std::vector<double>>
+deal2lkit::extract_rigid_body_modes(const DoFHandler<1, 3> &,
+                                    const ComponentMask &,
+                                    const Mapping<1, 3> &);
+template std::vector<std::vector<double>>
+deal2lkit::extract_rigid_body_modes(const DoFHandler<2, 2> &,
+                                    const ComponentMask &,
+                                    const Mapping<2, 2> &);
+template std::vector<std::vector<double>>
+deal2lkit::extract_rigid_body_modes(const DoFHandler<2, 3> &,
+                                    const ComponentMask &,
+                                    const Mapping<2, 3> &);
+template std::vector<std::vector<double>>
+deal2lkit::extract_rigid_body_modes(const DoFHandler<3, 3> &,
+                                    const ComponentMask &,
+                                    const Mapping<3, 3> &);
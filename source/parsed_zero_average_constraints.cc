@@ -13,8 +13,12 @@
 //
 //-----------------------------------------------------------
 
+#include <deal.II/base/quadrature_lib.h>
+
 #include <deal.II/dofs/dof_tools.h>
 
+#include <deal.II/fe/fe_values.h>
+
 #include <deal2lkit/parsed_zero_average_constraints.h>
 
 using namespace dealii;
@@ -36,6 +40,7 @@ ParsedZeroAverageConstraints<dim, spacedim>::ParsedZeroAverageConstraints(
   , mask(n_components, false)
   , boundary_mask(n_components, false)
   , n_components(n_components)
+  , projection_computed(false)
 {}
 
 template <int dim, int spacedim>
@@ -153,6 +158,18 @@ ParsedZeroAverageConstraints<dim, spacedim>::declare_parameters(
                 "You can specify the components either by numbers "
                 "or by the corrisponding variable name, which are parsed at "
                 "construction time. ");
+
+  add_parameter(prm,
+                &method,
+                "Zero average method",
+                "constraints",
+                Patterns::Selection("constraints|projection"),
+                "constraints: add a constraint line coupling the first dof "
+                "of each component with all the others.\n"
+                "projection: do not add any constraint. The zero average is "
+                "enforced through the operators returned by "
+                "mean_value_projection() and zero_average_operator(), "
+                "which keep the matrix sparse.");
 }
 
 template <>
@@ -197,30 +214,27 @@ ParsedZeroAverageConstraints<dim, spacedim>::internal_zero_average_constraints(
   const bool                       at_boundary,
   AffineConstraints<double> &      constraints) const
 {
+  IndexSet constrained_dofs;
   if (at_boundary)
     {
-      std::vector<bool> constrained_dofs(dof_handler.n_dofs(), false);
+#if DEAL_II_VERSION_GTE(9, 3, 0)
+      constrained_dofs = DoFTools::extract_boundary_dofs(dof_handler, mask);
+#else
       DoFTools::extract_boundary_dofs(dof_handler, mask, constrained_dofs);
-
-      const unsigned int first_dof = std::distance(
-        constrained_dofs.begin(),
-        std::find(constrained_dofs.begin(), constrained_dofs.end(), true));
-
-      constraints.add_line(first_dof);
-      for (unsigned int i = first_dof + 1; i < dof_handler.n_dofs(); ++i)
-        if (constrained_dofs[i] == true)
-          constraints.add_entry(first_dof, i, -1);
+#endif
     }
   else
-    {
-      const auto constrained_dofs = DoFTools::extract_dofs(dof_handler, mask);
-      auto       first_dof        = constrained_dofs.begin();
+    constrained_dofs = DoFTools::extract_dofs(dof_handler, mask);
 
-      constraints.add_line(*first_dof);
-      for (auto i : constrained_dofs)
-        if (i != *first_dof)
-          constraints.add_entry(*first_dof, i, -1);
-    }
+  if (constrained_dofs.n_elements() == 0)
+    return;
+
+  const auto first_dof = *constrained_dofs.begin();
+
+  constraints.add_line(first_dof);
+  for (auto i : constrained_dofs)
+    if (i != first_dof)
+      constraints.add_entry(first_dof, i, -1);
 }
 
 
@@ -230,6 +244,9 @@ ParsedZeroAverageConstraints<dim, spacedim>::apply_zero_average_constraints(
   const DoFHandler<dim, spacedim> &dof_handler,
   AffineConstraints<double> &      constraints) const
 {
+  if (method == "projection")
+    return;
+
   for (unsigned int i = 0; i < n_components; ++i)
     {
       std::vector<bool> m(n_components, false);
@@ -256,6 +273,106 @@ ParsedZeroAverageConstraints<dim, spacedim>::apply_zero_average_constraints(
 }
 
 
+
+template <int dim, int spacedim>
+void
+ParsedZeroAverageConstraints<dim, spacedim>::compute_mean_value_projection(
+  const DoFHandler<dim, spacedim> &dof_handler,
+  const Mapping<dim, spacedim> &   mapping)
+{
+  projection_dofs.clear();
+  projection_weights.clear();
+
+  const FiniteElement<dim, spacedim> &fe = dof_handler.get_fe();
+  const IndexSet &owned_dofs             = dof_handler.locally_owned_dofs();
+
+  const QGauss<dim>     quadrature(fe.degree + 1);
+  const QGauss<dim - 1> face_quadrature(fe.degree + 1);
+
+  FEValues<dim, spacedim> fe_values(mapping,
+                                    fe,
+                                    quadrature,
+                                    update_values | update_JxW_values);
+
+  FEFaceValues<dim, spacedim> fe_face_values(mapping,
+                                             fe,
+                                             face_quadrature,
+                                             update_values |
+                                               update_JxW_values);
+
+  std::vector<types::global_dof_index> dof_indices(fe.dofs_per_cell);
+
+  for (unsigned int c = 0; c < n_components; ++c)
+    {
+      if (!mask[c] && !boundary_mask[c])
+        continue;
+
+      std::vector<bool> m(n_components, false);
+      m[c] = true;
+
+      // The constants of this component, restricted to the locally
+      // owned dofs.
+      IndexSet dofs = DoFTools::extract_dofs(dof_handler, ComponentMask(m));
+      dofs          = dofs & owned_dofs;
+
+      std::vector<double> weights(dofs.n_elements(), 0.0);
+
+      // Cells in the ghost layer also contribute to the locally owned
+      // dofs, so that no communication is required.
+      for (const auto &cell : dof_handler.active_cell_iterators())
+        if (!cell->is_artificial())
+          {
+            cell->get_dof_indices(dof_indices);
+
+            // The whole domain takes precedence over the boundary.
+            if (mask[c])
+              {
+                fe_values.reinit(cell);
+                for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+                  if (fe.get_nonzero_components(i)[c] &&
+                      dofs.is_element(dof_indices[i]))
+                    {
+                      double w = 0;
+                      for (unsigned int q = 0; q < quadrature.size(); ++q)
+                        w += fe_values.shape_value_component(i, q, c) *
+                             fe_values.JxW(q);
+                      weights[dofs.index_within_set(dof_indices[i])] += w;
+                    }
+              }
+
+            else
+              for (unsigned int f = 0;
+                   f < GeometryInfo<dim>::faces_per_cell;
+                   ++f)
+                if (cell->face(f)->at_boundary())
+                  {
+                    fe_face_values.reinit(cell, f);
+                    for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+                      if (fe.get_nonzero_components(i)[c] &&
+                          dofs.is_element(dof_indices[i]))
+                        {
+                          double w = 0;
+                          for (unsigned int q = 0;
+                               q < face_quadrature.size();
+                               ++q)
+                            w += fe_face_values.shape_value_component(i,
+                                                                      q,
+                                                                      c) *
+                                 fe_face_values.JxW(q);
+                          weights[dofs.index_within_set(dof_indices[i])] +=
+                            w;
+                        }
+                  }
+          }
+
+      projection_dofs.push_back(dofs);
+      projection_weights.push_back(weights);
+    }
+
+  projection_computed = true;
+}
+
+
 D2K_NAMESPACE_CLOSE
 
 template class deal2lkit::ParsedZeroAverageConstraints<1, 1>;
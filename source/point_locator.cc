@@ -0,0 +1,245 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/fe/mapping.h>
+
+#include <deal2lkit/point_locator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+
+using namespace dealii;
+
+D2K_NAMESPACE_OPEN
+
+template <int dim, int spacedim>
+PointLocator<dim, spacedim>::PointLocator(
+  const DoFHandler<dim, spacedim> &dof_handler,
+  const Mapping<dim, spacedim> &   mapping)
+  : dof_handler(&dof_handler)
+  , mapping(&mapping)
+  , comm(dof_handler.get_triangulation().get_communicator())
+  , max_cell_diameter(0)
+{
+  tria_connection =
+    dof_handler.get_triangulation().signals.any_change.connect(
+      [this]() { clear(); });
+}
+
+
+
+template <int dim, int spacedim>
+PointLocator<dim, spacedim>::~PointLocator()
+{
+  tria_connection.disconnect();
+}
+
+
+
+template <int dim, int spacedim>
+void
+PointLocator<dim, spacedim>::clear()
+{
+  kdtree.reset();
+  vertices.points.clear();
+  vertices.cells.clear();
+  vertex_index.clear();
+}
+
+
+
+template <int dim, int spacedim>
+void
+PointLocator<dim, spacedim>::build_index() const
+{
+  if (kdtree)
+    return;
+
+  const Triangulation<dim, spacedim> &tria = dof_handler->get_triangulation();
+
+  // Number the vertices used by the locally owned cells, and store
+  // their position as seen by the mapping.
+  vertex_index.assign(tria.n_vertices(), numbers::invalid_unsigned_int);
+  vertices.points.clear();
+  vertices.cells.clear();
+  max_cell_diameter = 0;
+
+  for (const auto &cell : dof_handler->active_cell_iterators())
+    if (cell->is_locally_owned())
+      {
+        const auto mapped_vertices = mapping->get_vertices(cell);
+        for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell;
+             ++v)
+          for (unsigned int w = v + 1;
+               w < GeometryInfo<dim>::vertices_per_cell;
+               ++w)
+            max_cell_diameter =
+              std::max(max_cell_diameter,
+                       mapped_vertices[v].distance(mapped_vertices[w]));
+        for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell;
+             ++v)
+          {
+            unsigned int &index = vertex_index[cell->vertex_index(v)];
+            if (index == numbers::invalid_unsigned_int)
+              {
+                index = vertices.points.size();
+                vertices.points.push_back(mapped_vertices[v]);
+                vertices.cells.emplace_back();
+              }
+            vertices.cells[index].push_back(cell);
+          }
+      }
+
+  kdtree.reset(new KDTree(spacedim,
+                          vertices,
+                          nanoflann::KDTreeSingleIndexAdaptorParams(10)));
+  kdtree->buildIndex();
+}
+
+
+
+template <int dim, int spacedim>
+std::pair<typename PointLocator<dim, spacedim>::active_cell_iterator,
+          Point<dim>>
+PointLocator<dim, spacedim>::find_cell(const Point<spacedim> &p) const
+{
+  const double tolerance = 1e-10;
+
+  // Look for the cell among the ones around the closest vertices.
+  const unsigned int n_neighbors =
+    std::min<unsigned int>(4, vertices.points.size());
+  std::vector<unsigned int> indices(n_neighbors);
+  std::vector<double>       distances(n_neighbors);
+  nanoflann::KNNResultSet<double, unsigned int> result(n_neighbors);
+  result.init(&indices[0], &distances[0]);
+  kdtree->findNeighbors(result, &p[0], nanoflann::SearchParams());
+  const unsigned int n_found = result.size();
+
+  // A point inside a cell is closer to each of its vertices than the
+  // diameter of the cell. Curved cells may bulge out of the hull of
+  // their vertices, hence the safety factor. This discards without any
+  // search the points that are owned by other processes.
+  if (n_found == 0 ||
+      std::sqrt(distances[0]) > 2 * max_cell_diameter + tolerance)
+    return std::make_pair(dof_handler->end(), Point<dim>());
+
+  // Try the cells in the order in which they are given, skipping the
+  // ones that have already been tried.
+  std::set<active_cell_iterator> tried;
+  std::pair<active_cell_iterator, Point<dim>> found(dof_handler->end(),
+                                                    Point<dim>());
+  const auto search = [&](const std::vector<active_cell_iterator> &cells) {
+    for (const auto &cell : cells)
+      if (tried.insert(cell).second)
+        {
+          try
+            {
+              const Point<dim> p_unit =
+                mapping->transform_real_to_unit_cell(cell, p);
+              if (GeometryInfo<dim>::is_inside_unit_cell(p_unit, tolerance))
+                {
+                  found = std::make_pair(cell, p_unit);
+                  return true;
+                }
+            }
+          catch (
+            const typename Mapping<dim, spacedim>::ExcTransformationFailed &)
+            {
+              // The point is far away from this cell: try the next one.
+            }
+        }
+    return false;
+  };
+
+  std::vector<active_cell_iterator> cells;
+  for (unsigned int i = 0; i < n_found; ++i)
+    cells.insert(cells.end(),
+                 vertices.cells[indices[i]].begin(),
+                 vertices.cells[indices[i]].end());
+  if (search(cells))
+    return found;
+
+  // With curved or strongly distorted cells the point may lie in a
+  // cell that does not share any of the closest vertices: look among
+  // the locally owned cells sharing a vertex with the ones above.
+  std::vector<active_cell_iterator> neighbors;
+  for (const auto &cell : cells)
+    for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+      {
+        const auto &around =
+          vertices.cells[vertex_index[cell->vertex_index(v)]];
+        neighbors.insert(neighbors.end(), around.begin(), around.end());
+      }
+  if (search(neighbors))
+    return found;
+
+  return std::make_pair(dof_handler->end(), Point<dim>());
+}
+
+
+
+template <int dim, int spacedim>
+std::vector<
+  std::pair<typename PointLocator<dim, spacedim>::active_cell_iterator,
+            Point<dim>>>
+PointLocator<dim, spacedim>::locate(
+  const std::vector<Point<spacedim>> &points) const
+{
+  build_index();
+
+  std::vector<std::pair<active_cell_iterator, Point<dim>>> located(
+    points.size(), std::make_pair(dof_handler->end(), Point<dim>()));
+
+  if (vertices.points.size() > 0)
+    for (unsigned int i = 0; i < points.size(); ++i)
+      located[i] = find_cell(points[i]);
+
+  // Points on the interface between two processes are found by both:
+  // keep them only on the one with the lowest rank.
+  if (Utilities::MPI::n_mpi_processes(comm) > 1)
+    {
+      const unsigned int my_rank = Utilities::MPI::this_mpi_process(comm);
+      const unsigned int none    = std::numeric_limits<unsigned int>::max();
+
+      std::vector<unsigned int> owner(points.size(), none);
+      for (unsigned int i = 0; i < points.size(); ++i)
+        if (located[i].first != dof_handler->end())
+          owner[i] = my_rank;
+
+      std::vector<unsigned int> min_owner(points.size());
+      Utilities::MPI::min(owner, comm, min_owner);
+
+      for (unsigned int i = 0; i < points.size(); ++i)
+        if (min_owner[i] != my_rank)
+          located[i].first = dof_handler->end();
+    }
+
+  return located;
+}
+
+
+D2K_NAMESPACE_CLOSE
+
+template class deal2lkit::PointLocator<1, 1>;
+template class deal2lkit::PointLocator<1, 2>;
+template class deal2lkit::PointLocator<1, 3>;
+template class deal2lkit::PointLocator<2, 2>;
+template class deal2lkit::PointLocator<2, 3>;
+template class deal2lkit::PointLocator<3, 3>;
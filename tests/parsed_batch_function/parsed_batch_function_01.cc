@@ -0,0 +1,75 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// check that the batched evaluation of ParsedBatchFunction gives the same
+// values as the one of Functions::ParsedFunction, and that it falls back
+// to muParser for the expressions it does not support
+
+#include <deal2lkit/parsed_batch_function.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+void
+test(const std::string &expression, const std::string &constants)
+{
+  ParameterHandler prm;
+  Functions::ParsedFunction<2>::declare_parameters(prm, 2);
+  prm.set("Function expression", expression);
+  prm.set("Function constants", constants);
+
+  Functions::ParsedFunction<2> reference(2);
+  ParsedBatchFunction<2>       function(2);
+  reference.parse_parameters(prm);
+  function.parse_parameters(prm);
+  reference.set_time(0.3);
+  function.set_time(0.3);
+
+  // more points than a single batch
+  std::vector<Point<2>> points;
+  for (unsigned int i = 0; i < 100; ++i)
+    points.emplace_back(0.01 * i, 1 - 0.02 * i);
+
+  std::vector<Vector<double>> values(points.size(), Vector<double>(2));
+  std::vector<double>         first(points.size());
+  function.vector_value_list(points, values);
+  function.value_list(points, first, 0);
+
+  bool same = true;
+  for (unsigned int q = 0; q < points.size(); ++q)
+    for (unsigned int c = 0; c < 2; ++c)
+      if (std::abs(values[q](c) - reference.value(points[q], c)) > 1e-12 ||
+          std::abs(first[q] - reference.value(points[q], 0)) > 1e-12)
+        same = false;
+
+  deallog << expression << ": batched " << function.is_batched() << ", "
+          << (same ? "OK" : "Failed") << std::endl;
+}
+
+
+int
+main()
+{
+  initlog();
+
+  test("k*sin(pi*x)*cos(pi*y)*exp(-t); x^2-y/2", "k=2");
+  test("x < 0.5 ? y : -t^2; if(x>=y && t>0, 1, 0) + max(x,y,t)", "");
+  test("pow(x,2)/(1+y*y) - sqrt(abs(t)); 2^-1*x-y-t", "");
+  test("x^3*(1+y*y)^-2 + (x+y)^7 - x^2.5; tanh(x) + log(1+x) + (x!=y)",
+       "");
+  test("int(3*x); x", "");
+}
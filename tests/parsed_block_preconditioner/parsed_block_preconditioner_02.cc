@@ -0,0 +1,92 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2015 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Apply the "full schur" preconditioner of a small saddle point system
+// [A B; B^T 0], with the exact Schur complement -B^T A^{-1} B, and check
+// that it is the inverse of the system.
+
+#include <deal.II/lac/block_linear_operator.h>
+#include <deal.II/lac/block_vector.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal2lkit/parsed_block_preconditioner.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+using VEC  = Vector<double>;
+using BVEC = BlockVector<double>;
+
+int
+main()
+{
+  initlog();
+
+  ParsedBlockPreconditioner<BVEC> P("Block prec", "u,p");
+
+  ParameterHandler prm;
+  dealii::ParameterAcceptor::declare_all_parameters(prm);
+  prm.parse_input_from_string("subsection Block prec\n"
+                              "  set Structure = full schur\n"
+                              "  subsection Inner solver u\n"
+                              "    set Log result = false\n"
+                              "    set Reduction  = 1e-12\n"
+                              "  end\n"
+                              "  subsection Inner solver p\n"
+                              "    set Log result = false\n"
+                              "    set Reduction  = 1e-12\n"
+                              "  end\n"
+                              "end\n");
+  dealii::ParameterAcceptor::parse_all_parameters(prm);
+
+  FullMatrix<double> A(2, 2), B(2, 1), Bt(1, 2), S(1, 1), Z(1, 1);
+  A(0, 0) = 4;
+  A(0, 1) = 1;
+  A(1, 0) = 1;
+  A(1, 1) = 3;
+  B(0, 0) = 1;
+  B(1, 0) = 2;
+  Bt.copy_transposed(B);
+  S(0, 0) = 15. / 11.;
+
+  const auto op_A  = linear_operator<VEC>(A);
+  const auto op_B  = linear_operator<VEC>(B);
+  const auto op_Bt = linear_operator<VEC>(Bt);
+  const auto op_Z  = null_operator(linear_operator<VEC>(Z));
+  const auto op_S  = linear_operator<VEC>(S);
+
+  const auto system =
+    block_operator<2, 2, BVEC>({{{{op_A, op_B}}, {{op_Bt, op_Z}}}});
+
+  P.initialize_preconditioner(system,
+                              {op_A, -1.0 * op_S},
+                              {identity_operator(op_A),
+                               identity_operator(op_S)});
+
+  BVEC b(std::vector<types::global_dof_index>({2, 1}));
+  b.block(0)(0) = 1;
+  b.block(0)(1) = 2;
+  b.block(1)(0) = 3;
+
+  BVEC x(b), r(b);
+  P.vmult(x, b);
+  system.vmult(r, x);
+  r -= b;
+
+  deallog << "Residual below 1e-8: " << (r.l2_norm() < 1e-8) << std::endl;
+}
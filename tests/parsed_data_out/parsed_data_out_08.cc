@@ -0,0 +1,73 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2015 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Test that all processes write a single vtu file, together with its
+// pvtu record, when "Number of output files" is set to one.
+
+#include <deal.II/base/mpi.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal2lkit/parsed_data_out.h>
+#include <deal2lkit/utilities.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, numbers::invalid_unsigned_int);
+  mpi_initlog();
+
+  ParsedDataOut<2, 2> data_out("Data out", "vtu", 1, "", "output");
+
+  dealii::ParameterAcceptor::initialize(
+    SOURCE_DIR "/parameters/parsed_data_out_08.prm", "used_parameters.prm");
+
+  Triangulation<2> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(1);
+
+  FE_Q<2>       fe(1);
+  DoFHandler<2> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  Vector<double> solution(dof_handler.n_dofs());
+  solution = 1.;
+
+  data_out.prepare_data_output(dof_handler);
+  data_out.add_data_vector(solution, "u");
+  data_out.write_data_and_clear();
+
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  deallog << "Exist ./output.00.01.vtu = " << file_exists("./output.00.01.vtu")
+          << std::endl;
+  deallog << "Exist ./output.pvtu = " << file_exists("./output.pvtu")
+          << std::endl;
+  deallog << "Exist ./output.01.02.vtu = " << file_exists("./output.01.02.vtu")
+          << std::endl;
+}
@@ -0,0 +1,82 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2015 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Test the hdf5 output: the mesh is written only when the
+// triangulation changes.
+
+#include <deal.II/base/mpi.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal2lkit/parsed_data_out.h>
+#include <deal2lkit/utilities.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, numbers::invalid_unsigned_int);
+  initlog();
+
+  ParsedDataOut<2, 2> data_out("Data out", "vtu", 1, "", "output");
+
+  dealii::ParameterAcceptor::initialize(
+    SOURCE_DIR "/parameters/parsed_data_out_09.prm", "used_parameters.prm");
+
+  Triangulation<2> tria;
+  GridGenerator::hyper_cube(tria);
+
+  FE_Q<2>        fe(1);
+  DoFHandler<2>  dof_handler(tria);
+  Vector<double> solution;
+
+  for (unsigned int step = 0; step < 3; ++step)
+    {
+      // The mesh changes only before the last step.
+      if (step == 2)
+        tria.refine_global(1);
+
+      dof_handler.distribute_dofs(fe);
+      solution.reinit(dof_handler.n_dofs());
+      solution = step;
+
+      data_out.set_time(0.1 * step);
+      data_out.prepare_data_output(dof_handler,
+                                   "_" + Utilities::int_to_string(step, 2));
+      data_out.add_data_vector(solution, "u");
+      data_out.write_data_and_clear();
+    }
+
+  deallog << "Exist ./output_mesh.000.h5 = "
+          << file_exists("./output_mesh.000.h5") << std::endl;
+  deallog << "Exist ./output_mesh.001.h5 = "
+          << file_exists("./output_mesh.001.h5") << std::endl;
+  deallog << "Exist ./output_mesh.002.h5 = "
+          << file_exists("./output_mesh.002.h5") << std::endl;
+  deallog << "Exist ./output.xdmf = " << file_exists("./output.xdmf")
+          << std::endl;
+}
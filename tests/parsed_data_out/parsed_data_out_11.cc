@@ -0,0 +1,109 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2015 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Test that, after invalidate_geometry(), outputs built with cached patch
+// geometry follow a MappingQ1Eulerian whose displacement changes.
+
+#include <deal.II/base/mpi.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/mapping_q1_eulerian.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal2lkit/parsed_data_out.h>
+#include <deal2lkit/utilities.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+std::string
+read_without_date(const std::string &filename)
+{
+  std::ifstream in(filename.c_str());
+  std::string   line, content;
+  while (std::getline(in, line))
+    if (line.find("generated") == std::string::npos)
+      content += line + "\n";
+  return content;
+}
+
+int
+main(int argc, char *argv[])
+{
+#ifdef DEAL_II_WITH_MPI
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, numbers::invalid_unsigned_int);
+  mpi_initlog();
+#else
+  initlog();
+#endif
+
+  ParsedDataOut<2, 2> cached("Cached", "vtk", 1, "", "cached");
+  ParsedDataOut<2, 2> not_cached("Not cached", "vtk", 1, "", "not_cached");
+
+  dealii::ParameterAcceptor::initialize(
+    SOURCE_DIR "/parameters/parsed_data_out_11.prm", "used_parameters.prm");
+
+  Triangulation<2> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(2);
+
+  FE_Q<2>        fe(2);
+  FESystem<2>    fe_displacement(FE_Q<2>(1), 2);
+  DoFHandler<2>  dof_handler(tria);
+  DoFHandler<2>  displacement_dof_handler(tria);
+  Vector<double> solution, displacement;
+
+  dof_handler.distribute_dofs(fe);
+  displacement_dof_handler.distribute_dofs(fe_displacement);
+  solution.reinit(dof_handler.n_dofs());
+  displacement.reinit(displacement_dof_handler.n_dofs());
+
+  MappingQ1Eulerian<2> mapping(displacement_dof_handler, displacement);
+
+  for (unsigned int i = 0; i < solution.size(); ++i)
+    solution(i) = i % 5;
+
+  for (unsigned int step = 0; step < 2; ++step)
+    {
+      for (unsigned int i = 0; i < displacement.size(); ++i)
+        displacement(i) = 0.01 * (i % 3) * step;
+      cached.invalidate_geometry();
+
+      const std::string suffix = "_" + Utilities::int_to_string(step, 2);
+
+      cached.prepare_data_output(dof_handler, suffix);
+      cached.add_data_vector(solution, "u");
+      cached.write_data_and_clear(mapping);
+
+      not_cached.prepare_data_output(dof_handler, suffix);
+      not_cached.add_data_vector(solution, "u");
+      not_cached.write_data_and_clear(mapping);
+
+      deallog << "Same output: "
+              << (read_without_date("cached" + suffix + ".vtk") ==
+                  read_without_date("not_cached" + suffix + ".vtk"))
+              << std::endl;
+    }
+}
@@ -0,0 +1,113 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// check that the interpolation of the boundary values of all the ids
+// gives the same constraints as one call of
+// VectorTools::interpolate_boundary_values per id, also when the ids
+// share dofs and have different component masks
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/mapping_q1.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include <deal2lkit/parameter_acceptor.h>
+#include <deal2lkit/parsed_dirichlet_bcs.h>
+#include <deal2lkit/utilities.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+template <int dim>
+void
+test()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria, 0, 1, true);
+  tria.refine_global(2);
+
+  FESystem<dim>   fe(FE_Q<dim>(2), dim, FE_Q<dim>(1), 1);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+
+  const std::string u = (dim == 2 ? "x;y;" : "x;y;z;");
+  ParsedDirichletBCs<dim, dim> bcs("Dirichlet " + Utilities::int_to_string(dim),
+                                   dim + 1,
+                                   (dim == 2 ? "u,u,p" : "u,u,u,p"),
+                                   "0=ALL % 1=u % 2=p % 3=ALL",
+                                   "0=" + u + "1 % 1=" + u + "2 % 2=" + u +
+                                     "3 % 3=" + u + "x*y");
+  dealii::ParameterAcceptor::initialize();
+
+  const MappingQ1<dim>            mapping;
+  const std::vector<unsigned int> ids = bcs.get_mapped_ids();
+
+  AffineConstraints<double> constraints, reference_constraints;
+  bcs.interpolate_boundary_values(mapping, dof, constraints);
+  for (unsigned int i = 0; i < ids.size(); ++i)
+    VectorTools::interpolate_boundary_values(mapping,
+                                             dof,
+                                             ids[i],
+                                             *bcs.get_mapped_function(ids[i]),
+                                             reference_constraints,
+                                             bcs.get_mapped_mask(ids[i]));
+
+  bool same_constraints =
+    (constraints.n_constraints() == reference_constraints.n_constraints());
+  for (types::global_dof_index i = 0; i < dof.n_dofs(); ++i)
+    if (constraints.is_constrained(i) !=
+        reference_constraints.is_constrained(i))
+      same_constraints = false;
+    else if (constraints.is_constrained(i) &&
+             std::abs(constraints.get_inhomogeneity(i) -
+                      reference_constraints.get_inhomogeneity(i)) > 1e-12)
+      same_constraints = false;
+  deallog << "Constraints: " << (same_constraints ? "OK" : "Failed")
+          << std::endl;
+
+  std::map<types::global_dof_index, double> values, reference_values;
+  bcs.interpolate_boundary_values(dof, values);
+  for (unsigned int i = 0; i < ids.size(); ++i)
+    VectorTools::interpolate_boundary_values(dof,
+                                             ids[i],
+                                             *bcs.get_mapped_function(ids[i]),
+                                             reference_values,
+                                             bcs.get_mapped_mask(ids[i]));
+
+  bool same_values = (values.size() == reference_values.size());
+  for (const auto &v : reference_values)
+    if (values.find(v.first) == values.end() ||
+        std::abs(values[v.first] - v.second) > 1e-12)
+      same_values = false;
+  deallog << "Boundary values: " << (same_values ? "OK" : "Failed")
+          << std::endl;
+}
+
+
+int
+main()
+{
+  initlog();
+
+  test<2>();
+  test<3>();
+}
@@ -0,0 +1,92 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// check that update_inhomogeneities() gives the same closed constraints
+// as rebuilding them at the new time, also with hanging nodes on the
+// boundary
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal2lkit/parameter_acceptor.h>
+#include <deal2lkit/parsed_dirichlet_bcs.h>
+#include <deal2lkit/utilities.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+template <int dim>
+void
+test()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria, 0, 1, true);
+  tria.refine_global(1);
+  tria.begin_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  FE_Q<dim>       fe(2);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+
+  ParsedDirichletBCs<dim, dim> bcs("Dirichlet " + Utilities::int_to_string(dim),
+                                   1,
+                                   "u",
+                                   "0=ALL % 2=ALL % 3=ALL",
+                                   "0=x+t % 2=y*t*t % 3=1");
+  dealii::ParameterAcceptor::initialize();
+
+  AffineConstraints<double> constraints;
+  bcs.set_time(0.5);
+  DoFTools::make_hanging_node_constraints(dof, constraints);
+  bcs.interpolate_boundary_values(dof, constraints);
+  constraints.close();
+
+  for (const double t : {1.0, 2.0})
+    {
+      bcs.update_inhomogeneities(t, constraints);
+
+      AffineConstraints<double> reference;
+      DoFTools::make_hanging_node_constraints(dof, reference);
+      bcs.interpolate_boundary_values(dof, reference);
+      reference.close();
+
+      bool same = (constraints.n_constraints() == reference.n_constraints());
+      for (types::global_dof_index i = 0; i < dof.n_dofs(); ++i)
+        if (constraints.is_constrained(i) != reference.is_constrained(i))
+          same = false;
+        else if (constraints.is_constrained(i) &&
+                 std::abs(constraints.get_inhomogeneity(i) -
+                          reference.get_inhomogeneity(i)) > 1e-12)
+          same = false;
+      deallog << "t = " << t << ": " << (same ? "OK" : "Failed") << std::endl;
+    }
+}
+
+
+int
+main()
+{
+  initlog();
+
+  test<2>();
+  test<3>();
+}
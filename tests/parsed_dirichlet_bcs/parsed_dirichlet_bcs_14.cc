@@ -0,0 +1,300 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2015 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// check that the projection of the boundary values gives, dof by dof,
+// the same values as VectorTools::project_boundary_values called once
+// per id, both in a std::map and in an AffineConstraints object: on a
+// serial triangulation, on a distributed one, where the dofs are
+// matched through their support points, and on a three dimensional mesh
+// with hanging nodes on the boundary
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/fe_values.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include <deal2lkit/parameter_acceptor.h>
+#include <deal2lkit/parsed_dirichlet_bcs.h>
+#include <deal2lkit/utilities.h>
+
+#include "../tests.h"
+
+#include <set>
+#include <tuple>
+
+
+using namespace deal2lkit;
+
+// Boundary values computed by VectorTools::project_boundary_values once
+// per id, in a std::map and in an AffineConstraints object.
+template <int dim>
+void
+reference_values(const ParsedDirichletBCs<dim, dim> &       bcs,
+                 const DoFHandler<dim> &                    dof_handler,
+                 const Quadrature<dim - 1> &                quadrature,
+                 std::map<types::global_dof_index, double> &values,
+                 std::map<types::global_dof_index, double> &constrained)
+{
+  AffineConstraints<double> constraints;
+  for (const auto id : bcs.get_mapped_ids())
+    {
+      std::map<types::boundary_id, const Function<dim> *> function;
+      function[id] = bcs.get_mapped_function(id).get();
+      VectorTools::project_boundary_values(dof_handler,
+                                           function,
+                                           quadrature,
+                                           values);
+      VectorTools::project_boundary_values(dof_handler,
+                                           function,
+                                           quadrature,
+                                           constraints);
+    }
+  for (types::global_dof_index i = 0; i < dof_handler.n_dofs(); ++i)
+    if (constraints.is_constrained(i))
+      constrained[i] = constraints.get_inhomogeneity(i);
+}
+
+// The inhomogeneities of the constrained dofs among @p dofs.
+std::map<types::global_dof_index, double>
+inhomogeneities(const AffineConstraints<double> &constraints,
+                const IndexSet &                 dofs)
+{
+  std::map<types::global_dof_index, double> values;
+  for (const auto dof : dofs)
+    if (constraints.is_constrained(dof))
+      values[dof] = constraints.get_inhomogeneity(dof);
+  return values;
+}
+
+// Number of dofs which are missing in one of the two maps, or whose
+// values differ.
+unsigned int
+n_differences(const std::map<types::global_dof_index, double> &values,
+              const std::map<types::global_dof_index, double> &reference)
+{
+  unsigned int n = 0;
+  for (const auto &v : values)
+    {
+      const auto r = reference.find(v.first);
+      if (r == reference.end() || std::abs(v.second - r->second) > 1e-8)
+        ++n;
+    }
+  for (const auto &r : reference)
+    if (values.find(r.first) == values.end())
+      ++n;
+  return n;
+}
+
+// The component, the support point and the value of the locally owned
+// dofs of @p values.
+std::vector<std::tuple<unsigned int, Point<2>, double>>
+located_values(const DoFHandler<2> &                            dof_handler,
+               const std::map<types::global_dof_index, double> &values)
+{
+  const FiniteElement<2> &fe = dof_handler.get_fe();
+  FEValues<2>             fe_values(fe,
+                        Quadrature<2>(fe.get_unit_support_points()),
+                        update_quadrature_points);
+  std::vector<types::global_dof_index> dofs(fe.dofs_per_cell);
+  std::set<types::global_dof_index>    found;
+
+  std::vector<std::tuple<unsigned int, Point<2>, double>> located;
+  for (const auto &cell : dof_handler.active_cell_iterators())
+    if (cell->is_locally_owned())
+      {
+        fe_values.reinit(cell);
+        cell->get_dof_indices(dofs);
+        for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+          {
+            const auto v = values.find(dofs[i]);
+            if (v != values.end() &&
+                dof_handler.locally_owned_dofs().is_element(dofs[i]) &&
+                found.insert(dofs[i]).second)
+              located.emplace_back(fe.system_to_component_index(i).first,
+                                   fe_values.quadrature_point(i),
+                                   v->second);
+          }
+      }
+  return located;
+}
+
+// Number of locally owned dofs of @p values which do not have the value
+// of the dof of @p reference with the same component and support point,
+// plus the number of dofs of @p reference without a counterpart, over
+// all the processes.
+unsigned int
+n_located_differences(
+  const DoFHandler<2> &                            dof_handler,
+  const std::map<types::global_dof_index, double> &values,
+  const DoFHandler<2> &                            serial_dof_handler,
+  const std::map<types::global_dof_index, double> &reference)
+{
+  const auto located           = located_values(dof_handler, values);
+  const auto located_reference = located_values(serial_dof_handler, reference);
+
+  unsigned int n = 0;
+  for (const auto &v : located)
+    {
+      bool matched = false;
+      for (const auto &r : located_reference)
+        if (std::get<0>(v) == std::get<0>(r) &&
+            std::get<1>(v).distance(std::get<1>(r)) < 1e-12 &&
+            std::abs(std::get<2>(v) - std::get<2>(r)) < 1e-8)
+          matched = true;
+      if (!matched)
+        ++n;
+    }
+
+  const unsigned int n_values = Utilities::MPI::sum(
+    static_cast<unsigned int>(located.size()), MPI_COMM_WORLD);
+  return Utilities::MPI::sum(n, MPI_COMM_WORLD) +
+         (n_values == located_reference.size() ? 0 : 1);
+}
+
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, numbers::invalid_unsigned_int);
+  mpi_initlog();
+
+  // The ids 0, 1 and 2 share the corners of the square.
+  ParsedDirichletBCs<2, 2> bcs("Dirichlet",
+                               2,
+                               "u,v",
+                               "0=ALL % 1=ALL % 2=ALL",
+                               "0=x*y+1;y % 1=x*x;0 % 2=0;sin(x)");
+  ParsedDirichletBCs<3, 3> bcs_3d("Dirichlet 3d",
+                                  1,
+                                  "u",
+                                  "0=ALL % 2=ALL % 4=ALL",
+                                  "0=x+y*z % 2=y*y % 4=1");
+  dealii::ParameterAcceptor::initialize();
+
+  const FE_Q<2>     fe_q(2);
+  const FESystem<2> fe(fe_q, 2);
+  const QGauss<1>   quadrature(3);
+
+  Triangulation<2> serial_tria;
+  GridGenerator::hyper_cube(serial_tria, 0, 1, true);
+  serial_tria.refine_global(3);
+  DoFHandler<2> serial_dof_handler(serial_tria);
+  serial_dof_handler.distribute_dofs(fe);
+
+  std::map<types::global_dof_index, double> reference, constrained_reference;
+  reference_values(bcs,
+                   serial_dof_handler,
+                   quadrature,
+                   reference,
+                   constrained_reference);
+
+  std::map<types::global_dof_index, double> serial_values;
+  bcs.project_boundary_values(serial_dof_handler, quadrature, serial_values);
+  deallog << "Serial map: "
+          << (n_differences(serial_values, reference) == 0 ? "OK" : "Failed")
+          << std::endl;
+
+  AffineConstraints<double> serial_constraints;
+  bcs.project_boundary_values(serial_dof_handler,
+                              quadrature,
+                              serial_constraints);
+  serial_constraints.close();
+  deallog << "Serial constraints: "
+          << (n_differences(inhomogeneities(serial_constraints,
+                                            complete_index_set(
+                                              serial_dof_handler.n_dofs())),
+                            constrained_reference) == 0 ?
+                "OK" :
+                "Failed")
+          << std::endl;
+
+  parallel::distributed::Triangulation<2> tria(MPI_COMM_WORLD);
+  GridGenerator::hyper_cube(tria, 0, 1, true);
+  tria.refine_global(3);
+  DoFHandler<2> dof_handler(tria);
+  dof_handler.distribute_dofs(fe);
+
+  std::map<types::global_dof_index, double> values;
+  bcs.project_boundary_values(dof_handler, quadrature, values);
+  deallog << "Distributed map: "
+          << (n_located_differences(dof_handler,
+                                    values,
+                                    serial_dof_handler,
+                                    reference) == 0 ?
+                "OK" :
+                "Failed")
+          << std::endl;
+
+  IndexSet relevant_dofs;
+  DoFTools::extract_locally_relevant_dofs(dof_handler, relevant_dofs);
+  AffineConstraints<double> constraints(relevant_dofs);
+  bcs.project_boundary_values(dof_handler, quadrature, constraints);
+  constraints.close();
+  deallog << "Distributed constraints: "
+          << (n_located_differences(dof_handler,
+                                    inhomogeneities(constraints,
+                                                    relevant_dofs),
+                                    serial_dof_handler,
+                                    constrained_reference) == 0 ?
+                "OK" :
+                "Failed")
+          << std::endl;
+
+  // A cube with a refined corner cell: the coarse boundary faces next to
+  // it have hanging nodes on their edges.
+  Triangulation<3> tria_3d;
+  GridGenerator::hyper_cube(tria_3d, 0, 1, true);
+  tria_3d.refine_global(1);
+  tria_3d.begin_active()->set_refine_flag();
+  tria_3d.execute_coarsening_and_refinement();
+  const FE_Q<3>   fe_3d(2);
+  DoFHandler<3>   dof_handler_3d(tria_3d);
+  const QGauss<2> quadrature_3d(3);
+  dof_handler_3d.distribute_dofs(fe_3d);
+
+  std::map<types::global_dof_index, double> reference_3d,
+    constrained_reference_3d;
+  reference_values(bcs_3d,
+                   dof_handler_3d,
+                   quadrature_3d,
+                   reference_3d,
+                   constrained_reference_3d);
+
+  AffineConstraints<double> constraints_3d;
+  bcs_3d.project_boundary_values(dof_handler_3d,
+                                 quadrature_3d,
+                                 constraints_3d);
+  constraints_3d.close();
+  deallog << "3d hanging nodes: "
+          << (n_differences(inhomogeneities(constraints_3d,
+                                            complete_index_set(
+                                              dof_handler_3d.n_dofs())),
+                            constrained_reference_3d) == 0 ?
+                "OK" :
+                "Failed")
+          << std::endl;
+}
@@ -0,0 +1,64 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2015 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Read a grid file on the first process only, and check that every
+// process gets the whole coarse mesh with its boundary ids.
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal2lkit/parsed_grid_generator.h>
+#include <deal2lkit/utilities.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+  MPILogInitAll                    log;
+
+  ParsedGridGenerator<2, 2> pgg("Cube");
+
+  ParameterHandler prm;
+  dealii::ParameterAcceptor::declare_all_parameters(prm);
+
+  prm.parse_input_from_string(""
+                              "subsection Cube\n"
+                              "  set Grid to generate = file \n"
+                              "  set Input grid file name = " SOURCE_DIR
+                              "/grids/mesh_22.msh\n"
+                              "end\n");
+
+  dealii::ParameterAcceptor::parse_all_parameters(prm);
+
+  auto tria = pgg.distributed(MPI_COMM_WORLD);
+
+  deallog << "Active cells: " << tria->n_global_active_cells() << std::endl;
+
+  std::vector<unsigned int> n_faces(4, 0);
+  for (const auto &cell : tria->active_cell_iterators())
+    if (cell->is_locally_owned())
+      for (unsigned int f = 0; f < GeometryInfo<2>::faces_per_cell; ++f)
+        if (cell->face(f)->at_boundary())
+          ++n_faces[cell->face(f)->boundary_id()];
+
+  for (unsigned int id = 0; id < n_faces.size(); ++id)
+    deallog << "Boundary id " << id << ": "
+            << Utilities::MPI::sum(n_faces[id], MPI_COMM_WORLD) << std::endl;
+}
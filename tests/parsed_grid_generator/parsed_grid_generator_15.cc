@@ -0,0 +1,74 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2015 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Create a fully distributed triangulation, and check that the whole
+// refined mesh is split among the processes.
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/utilities.h>
+
+#include <deal2lkit/parsed_grid_generator.h>
+#include <deal2lkit/utilities.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+  MPILogInitAll                    log;
+
+  ParsedGridGenerator<2, 2> pgg("Cube");
+
+  ParameterHandler prm;
+  dealii::ParameterAcceptor::declare_all_parameters(prm);
+
+  prm.parse_input_from_string(""
+                              "subsection Cube\n"
+                              "  set Grid to generate = file \n"
+                              "  set Input grid file name = " SOURCE_DIR
+                              "/grids/mesh_22.msh\n"
+                              "end\n");
+
+  dealii::ParameterAcceptor::parse_all_parameters(prm);
+
+  auto tria = pgg.fully_distributed(MPI_COMM_WORLD, 2);
+
+  unsigned int n_owned       = 0;
+  unsigned int n_top_faces   = 0;
+  double       owned_measure = 0;
+  for (const auto &cell : tria->active_cell_iterators())
+    if (cell->is_locally_owned())
+      {
+        ++n_owned;
+        owned_measure += cell->measure();
+        for (unsigned int f = 0; f < GeometryInfo<2>::faces_per_cell; ++f)
+          if (cell->face(f)->at_boundary() && cell->face(f)->boundary_id() == 3)
+            ++n_top_faces;
+      }
+
+  deallog << "Has locally owned cells: " << (n_owned > 0) << std::endl;
+  deallog << "Stores only part of the mesh: "
+          << (tria->n_active_cells() < 64) << std::endl;
+  deallog << "Active cells: " << Utilities::MPI::sum(n_owned, MPI_COMM_WORLD)
+          << std::endl;
+  deallog << "Faces with boundary id 3: "
+          << Utilities::MPI::sum(n_top_faces, MPI_COMM_WORLD) << std::endl;
+  deallog << "Area: " << Utilities::MPI::sum(owned_measure, MPI_COMM_WORLD)
+          << std::endl;
+}
@@ -0,0 +1,72 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2015 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Create a refined grid twice with a triangulation cache, and check that
+// the second one is loaded from the cache with its manifolds attached.
+
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/grid/grid_out.h>
+
+#include <deal2lkit/parsed_grid_generator.h>
+#include <deal2lkit/utilities.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+int
+main()
+{
+  initlog();
+  std::system("rm -rf tria_cache");
+
+  ParsedGridGenerator<2, 2> pgg("Ball");
+
+  ParameterHandler prm;
+  dealii::ParameterAcceptor::declare_all_parameters(prm);
+
+  prm.parse_input_from_string(""
+                              "subsection Ball\n"
+                              "  set Grid to generate = hyper_ball \n"
+                              "  set Optional Point<spacedim> 1 = 0,0\n"
+                              "  set Optional double 1 = 1.0\n"
+                              "  set Triangulation cache directory = "
+                              "tria_cache\n"
+                              "end\n");
+
+  dealii::ParameterAcceptor::parse_all_parameters(prm);
+
+  auto tria = pgg.serial(2);
+  deallog << "Cache directory created: " << dir_exists("tria_cache")
+          << std::endl;
+  deallog << "Active cells: " << tria->n_active_cells() << std::endl;
+
+  auto cached_tria = pgg.serial(2);
+  deallog << "Active cells: " << cached_tria->n_active_cells() << std::endl;
+
+  // Refining the cached grid once more must still follow the circle.
+  tria->refine_global(1);
+  cached_tria->refine_global(1);
+  double max_distance = 0;
+  for (unsigned int v = 0; v < tria->n_vertices(); ++v)
+    max_distance = std::max(max_distance,
+                            tria->get_vertices()[v].distance(
+                              cached_tria->get_vertices()[v]));
+  deallog << "Same vertices: " << (max_distance < 1e-12) << std::endl;
+
+  std::system("rm -rf tria_cache");
+}
@@ -0,0 +1,80 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2015 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Use the same CAD file for two manifold descriptors, and check that the
+// refined grid is the same as the one obtained with the
+// NormalProjectionManifold of deal.II.
+
+#include <deal.II/base/utilities.h>
+
+#include <deal.II/opencascade/boundary_lib.h>
+#include <deal.II/opencascade/utilities.h>
+
+#include <deal2lkit/parsed_grid_generator.h>
+#include <deal2lkit/utilities.h>
+
+#include <sstream>
+#include <string>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+using namespace OpenCASCADE;
+
+int
+main()
+{
+  initlog();
+
+  const std::string file_name = SOURCE_DIR "/iges_files/sphere.iges";
+
+  ParsedGridGenerator<3, 3> pgg("Default");
+
+  ParameterHandler prm;
+  dealii::ParameterAcceptor::declare_all_parameters(prm);
+  std::stringstream input;
+
+  input << "subsection Default" << std::endl
+        << "  set Copy boundary to manifold ids = true" << std::endl
+        << "  set Colorize = true" << std::endl
+        << "  set Manifold descriptors = 0=NormalProjectionManifold:"
+        << file_name << "%1=NormalProjectionManifold:" << file_name
+        << std::endl
+        << "end" << std::endl;
+
+  prm.parse_input_from_string(input.str().c_str());
+  dealii::ParameterAcceptor::parse_all_parameters(prm);
+
+  auto tria = pgg.serial();
+  tria->refine_global(1);
+
+  // Same grid, with the manifolds of deal.II replacing the ones of pgg
+  Triangulation<3> reference;
+  pgg.create(reference);
+  const NormalProjectionManifold<3, 3> manifold(read_IGES(file_name));
+  reference.set_manifold(0, manifold);
+  reference.set_manifold(1, manifold);
+  reference.refine_global(1);
+
+  double max_distance = 0;
+  for (unsigned int v = 0; v < tria->n_vertices(); ++v)
+    max_distance = std::max(max_distance,
+                            tria->get_vertices()[v].distance(
+                              reference.get_vertices()[v]));
+
+  deallog << "Vertices: " << tria->n_vertices() << std::endl;
+  deallog << "Same vertices: " << (max_distance < 1e-6) << std::endl;
+}
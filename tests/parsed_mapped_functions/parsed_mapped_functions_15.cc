@@ -0,0 +1,48 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// test the detection of the time dependent ids
+
+
+#include <deal2lkit/parameter_acceptor.h>
+#include <deal2lkit/parsed_mapped_functions.h>
+#include <deal2lkit/utilities.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+
+int
+main()
+{
+  initlog();
+  ParsedMappedFunctions<2> pmf(
+    "Mapped Functions",
+    3,
+    "u,u,p",
+    "0=u % 1=1 % 2=ALL % 6=u;p",
+    "0=x;y;0 % 1=0;exp(-t);0 % 2=tan(x);1e-3*y;0 % 6=t2;0;k",
+    "k=1,t2=2");
+
+  dealii::ParameterAcceptor::initialize();
+
+  std::vector<unsigned int> ids = pmf.get_mapped_ids();
+  for (unsigned int i = 0; i < ids.size(); ++i)
+    deallog << "Id " << ids[i] << " time dependent: "
+            << (pmf.is_time_dependent(ids[i]) ? "true" : "false")
+            << std::endl;
+}
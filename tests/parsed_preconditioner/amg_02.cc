@@ -0,0 +1,123 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Initialize the preconditioner twice for the same matrix object with
+// the "reuse aggregates" policy, after scaling its entries, and check
+// that the hierarchy is reused and that the number of iterations does
+// not change. Then reinitialize the matrix with a different sparsity
+// pattern, and check that the hierarchy is built again.
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/trilinos_sparse_matrix.h>
+#include <deal.II/lac/trilinos_vector.h>
+
+#include <deal.II/numerics/matrix_tools.h>
+
+#include <deal2lkit/parsed_preconditioner/amg.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+unsigned int
+solve(const TrilinosWrappers::SparseMatrix &matrix,
+      const ParsedAMGPreconditioner &       prec,
+      const double                          scaling)
+{
+  TrilinosWrappers::MPI::Vector x(matrix.locally_owned_domain_indices(),
+                                  MPI_COMM_WORLD);
+  TrilinosWrappers::MPI::Vector b(x);
+  b = scaling;
+
+  SolverControl                               control(1000, 1e-10);
+  SolverCG<TrilinosWrappers::MPI::Vector> cg(control);
+  cg.solve(matrix, x, b, prec);
+  return control.last_step();
+}
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, numbers::invalid_unsigned_int);
+
+  initlog();
+
+  ParsedAMGPreconditioner AMG("AMG prec");
+
+  ParameterHandler prm;
+  dealii::ParameterAcceptor::declare_all_parameters(prm);
+  prm.parse_input_from_string("subsection AMG prec\n"
+                              "  set Hierarchy reuse policy = "
+                              "reuse aggregates\n"
+                              "end\n");
+  dealii::ParameterAcceptor::parse_all_parameters(prm);
+
+  Triangulation<2> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(5);
+
+  FE_Q<2>       fe(1);
+  DoFHandler<2> dh(tria);
+  dh.distribute_dofs(fe);
+
+  DynamicSparsityPattern dsp(dh.n_dofs());
+  DoFTools::make_sparsity_pattern(dh, dsp);
+
+  TrilinosWrappers::SparseMatrix matrix;
+  matrix.reinit(dsp);
+  MatrixCreator::create_laplace_matrix(dh, QGauss<2>(2), matrix);
+  for (unsigned int i = 0; i < dh.n_dofs(); ++i)
+    matrix.add(i, i, 1.0);
+  matrix.compress(VectorOperation::add);
+
+  AMG.initialize_preconditioner(matrix);
+  const unsigned int first = solve(matrix, AMG, 1.0);
+
+  matrix *= 2.0;
+  AMG.initialize_preconditioner(matrix);
+  deallog << "Reused hierarchy: " << AMG.reused_hierarchy() << std::endl;
+  const unsigned int second = solve(matrix, AMG, 2.0);
+
+  deallog << "Converged: " << (first < 1000) << std::endl;
+  deallog << "Same iterations: " << (first == second) << std::endl;
+
+  DynamicSparsityPattern flux_dsp(dh.n_dofs());
+  DoFTools::make_flux_sparsity_pattern(dh, flux_dsp);
+  matrix.reinit(flux_dsp);
+  MatrixCreator::create_laplace_matrix(dh, QGauss<2>(2), matrix);
+  for (unsigned int i = 0; i < dh.n_dofs(); ++i)
+    matrix.add(i, i, 1.0);
+  matrix.compress(VectorOperation::add);
+
+  AMG.initialize_preconditioner(matrix);
+  deallog << "Reused hierarchy after reinit: " << AMG.reused_hierarchy()
+          << std::endl;
+  deallog << "Converged after reinit: " << (solve(matrix, AMG, 1.0) < 1000)
+          << std::endl;
+}
@@ -0,0 +1,116 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Check that a ParsedSolver reports its iterations to the preconditioner
+// with the "reuse until iteration growth" policy: the hierarchy is
+// reused after a solve with few iterations, and rebuilt after a solve
+// with many more iterations.
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/linear_operator.h>
+#include <deal.II/lac/trilinos_sparse_matrix.h>
+#include <deal.II/lac/trilinos_vector.h>
+
+#include <deal.II/numerics/matrix_tools.h>
+
+#include <deal2lkit/parsed_preconditioner/amg.h>
+#include <deal2lkit/parsed_solver.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+typedef TrilinosWrappers::MPI::Vector VEC;
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, numbers::invalid_unsigned_int);
+
+  initlog();
+
+  ParsedAMGPreconditioner AMG("AMG prec");
+  ParsedSolver<VEC>       Ainv("Solver", "cg");
+
+  ParameterHandler prm;
+  dealii::ParameterAcceptor::declare_all_parameters(prm);
+  prm.parse_input_from_string("subsection AMG prec\n"
+                              "  set Hierarchy reuse policy = "
+                              "reuse until iteration growth\n"
+                              "  set Maximum iteration growth = 50\n"
+                              "end\n"
+                              "subsection Solver\n"
+                              "  set Reduction  = 1e-2\n"
+                              "  set Tolerance  = 1e-14\n"
+                              "  set Log result = false\n"
+                              "end\n");
+  dealii::ParameterAcceptor::parse_all_parameters(prm);
+
+  Triangulation<2> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(4);
+
+  FE_Q<2>       fe(1);
+  DoFHandler<2> dh(tria);
+  dh.distribute_dofs(fe);
+
+  DynamicSparsityPattern dsp(dh.n_dofs());
+  DoFTools::make_sparsity_pattern(dh, dsp);
+
+  TrilinosWrappers::SparseMatrix matrix;
+  matrix.reinit(dsp);
+  MatrixCreator::create_laplace_matrix(dh, QGauss<2>(2), matrix);
+  for (unsigned int i = 0; i < dh.n_dofs(); ++i)
+    matrix.add(i, i, 1.0);
+  matrix.compress(VectorOperation::add);
+
+  Ainv.op   = linear_operator<VEC>(matrix);
+  Ainv.prec = linear_operator<VEC>(matrix, AMG);
+  Ainv.report_iterations_to(AMG);
+
+  VEC b(matrix.locally_owned_domain_indices(), MPI_COMM_WORLD);
+  VEC x(b);
+  b = 1.0;
+
+  AMG.initialize_preconditioner(matrix);
+  x = Ainv * b;
+  const unsigned int few = Ainv.control.last_step();
+
+  AMG.initialize_preconditioner(matrix);
+  deallog << "After the first solve, reused: " << AMG.reused_hierarchy()
+          << std::endl;
+
+  Ainv.control.set_reduction(1e-12);
+  x = Ainv * b;
+  const unsigned int many = Ainv.control.last_step();
+  deallog << "More than 50% more iterations: " << (2 * many > 3 * few)
+          << std::endl;
+
+  AMG.initialize_preconditioner(matrix);
+  deallog << "After the second solve, reused: " << AMG.reused_hierarchy()
+          << std::endl;
+}
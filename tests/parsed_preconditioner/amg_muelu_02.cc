@@ -0,0 +1,137 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Initialize the preconditioner twice for the same distributed matrix
+// with the "RP" reuse type and repartitioning, after scaling its
+// entries. Check that the hierarchy is reused, that the number of
+// iterations does not change, and that the coarse levels are gathered on
+// a single process.
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/sparsity_tools.h>
+#include <deal.II/lac/trilinos_sparse_matrix.h>
+#include <deal.II/lac/trilinos_vector.h>
+
+#include <deal.II/numerics/matrix_tools.h>
+
+#include <deal2lkit/parsed_preconditioner/amg_muelu.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+unsigned int
+solve(const TrilinosWrappers::SparseMatrix &matrix,
+      const ParsedAMGMueLuPreconditioner &  prec,
+      const double                          scaling)
+{
+  TrilinosWrappers::MPI::Vector x(matrix.locally_owned_domain_indices(),
+                                  MPI_COMM_WORLD);
+  TrilinosWrappers::MPI::Vector b(x);
+  b = scaling;
+
+  SolverControl                               control(1000, 1e-10);
+  SolverCG<TrilinosWrappers::MPI::Vector> cg(control);
+  cg.solve(matrix, x, b, prec);
+  return control.last_step();
+}
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, numbers::invalid_unsigned_int);
+
+  mpi_initlog();
+
+  ParsedAMGMueLuPreconditioner AMGMueLu("AMGMueLu prec");
+
+  // Every coarse level is too small to be distributed.
+  ParameterHandler prm;
+  dealii::ParameterAcceptor::declare_all_parameters(prm);
+  prm.parse_input_from_string("subsection AMGMueLu prec\n"
+                              "  set Reuse type   = RP\n"
+                              "  set Repartition  = true\n"
+                              "  set Repartition minimum rows per process = "
+                              "1000000\n"
+                              "  set Repartition start level = 1\n"
+                              "end\n");
+  dealii::ParameterAcceptor::parse_all_parameters(prm);
+
+  parallel::distributed::Triangulation<2> tria(MPI_COMM_WORLD);
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(7);
+
+  FE_Q<2>       fe(1);
+  DoFHandler<2> dh(tria);
+  dh.distribute_dofs(fe);
+
+  IndexSet relevant_dofs;
+  DoFTools::extract_locally_relevant_dofs(dh, relevant_dofs);
+  DynamicSparsityPattern dsp(relevant_dofs);
+  DoFTools::make_sparsity_pattern(dh, dsp);
+  SparsityTools::distribute_sparsity_pattern(dsp,
+                                             dh.locally_owned_dofs(),
+                                             MPI_COMM_WORLD,
+                                             relevant_dofs);
+
+  TrilinosWrappers::SparseMatrix matrix;
+  matrix.reinit(dh.locally_owned_dofs(),
+                dh.locally_owned_dofs(),
+                dsp,
+                MPI_COMM_WORLD);
+  MatrixCreator::create_laplace_matrix(dh, QGauss<2>(2), matrix);
+  for (const auto i : dh.locally_owned_dofs())
+    matrix.add(i, i, 1.0);
+  matrix.compress(VectorOperation::add);
+
+  AMGMueLu.initialize_preconditioner(matrix);
+  const unsigned int first = solve(matrix, AMGMueLu, 1.0);
+
+  matrix *= 2.0;
+  AMGMueLu.initialize_preconditioner(matrix);
+  deallog << "Reused hierarchy: " << AMGMueLu.reused_hierarchy()
+          << std::endl;
+  const unsigned int second = solve(matrix, AMGMueLu, 2.0);
+
+  deallog << "Converged: " << (first < 1000) << std::endl;
+  deallog << "Same iterations: " << (first == second) << std::endl;
+
+  const std::vector<unsigned int> n_processes =
+    AMGMueLu.n_processes_per_level();
+  bool coarse_levels_on_one_process = true;
+  for (unsigned int l = 1; l < n_processes.size(); ++l)
+    if (n_processes[l] != 1)
+      coarse_levels_on_one_process = false;
+  deallog << "Coarse levels: " << (n_processes.size() > 1) << std::endl;
+  deallog << "Finest level on all processes: " << (n_processes[0] == 2)
+          << std::endl;
+  deallog << "Coarse levels on one process: " << coarse_levels_on_one_process
+          << std::endl;
+}
@@ -0,0 +1,109 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Solve the Poisson problem with a fourth order FE_Q on a matrix-free
+// operator, preconditioned by ParsedGMGPreconditioner through
+// ParsedSolver, and check that multigrid converges in a few iterations.
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q1.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/linear_operator.h>
+
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include <deal2lkit/parsed_preconditioner/gmg.h>
+#include <deal2lkit/parsed_solver.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+using VEC = LinearAlgebra::distributed::Vector<double>;
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, numbers::invalid_unsigned_int);
+
+  initlog();
+
+  Triangulation<2> tria(
+    Triangulation<2>::limit_level_difference_at_vertices);
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(4);
+
+  FE_Q<2>       fe(4);
+  DoFHandler<2> dh(tria);
+  dh.distribute_dofs(fe);
+  dh.distribute_mg_dofs();
+
+  MappingQ1<2> mapping;
+
+  AffineConstraints<double> constraints;
+  VectorTools::interpolate_boundary_values(
+    mapping, dh, 0, Functions::ZeroFunction<2>(), constraints);
+  constraints.close();
+
+  typename MatrixFree<2, double>::AdditionalData additional_data;
+  additional_data.mapping_update_flags = update_gradients | update_JxW_values;
+  auto matrix_free = std::make_shared<MatrixFree<2, double>>();
+  matrix_free->reinit(
+    mapping, dh, constraints, QGauss<1>(fe.degree + 1), additional_data);
+
+  ParsedGMGPreconditioner<2>::LevelMatrix A;
+  A.initialize(matrix_free);
+
+  ParsedGMGPreconditioner<2> gmg("GMG prec");
+  ParsedSolver<VEC>          Ainv("Solver",
+                         "cg",
+                         100,
+                         1e-10,
+                         linear_operator<VEC>(A),
+                         linear_operator<VEC>(A, gmg));
+
+  ParameterHandler prm;
+  dealii::ParameterAcceptor::declare_all_parameters(prm);
+  prm.parse_input_from_string("subsection Solver\n"
+                              "  set Log result = false\n"
+                              "end\n");
+  dealii::ParameterAcceptor::parse_all_parameters(prm);
+
+  gmg.initialize_preconditioner(dh, mapping, {0});
+
+  VEC x, b;
+  A.initialize_dof_vector(x);
+  A.initialize_dof_vector(b);
+  b = 1.0;
+  constraints.set_zero(b);
+
+  Ainv.vmult(x, b);
+
+  deallog << "Converged in less than 20 iterations: "
+          << (Ainv.control.last_step() < 20) << std::endl;
+}
@@ -0,0 +1,64 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Check the rigid body modes of a two dimensional displacement field on
+// the unit square, refined once: the translations are one on all the
+// nine vertices, the rotation is (-y, x).
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal2lkit/parsed_preconditioner/rigid_body_modes.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+int
+main()
+{
+  initlog();
+
+  Triangulation<2> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(1);
+
+  FESystem<2>   fe(FE_Q<2>(1), 2);
+  DoFHandler<2> dh(tria);
+  dh.distribute_dofs(fe);
+
+  const FEValuesExtractors::Vector displacement(0);
+  const auto                       modes =
+    extract_rigid_body_modes(dh, fe.component_mask(displacement));
+
+  deallog << "Number of modes: " << modes.size() << std::endl;
+  for (unsigned int m = 0; m < modes.size(); ++m)
+    {
+      double sum = 0, norm_square = 0;
+      for (const auto v : modes[m])
+        {
+          sum += v;
+          norm_square += v * v;
+        }
+      deallog << "Mode " << m << ": sum " << sum << ", squared norm "
+              << norm_square << std::endl;
+    }
+}
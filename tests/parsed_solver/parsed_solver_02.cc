@@ -0,0 +1,83 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2015 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Solve A x_k = (k+1) b for k = 0, ..., 3 with a linear extrapolation of
+// the previous solutions as initial guess. From the third solve on, the
+// initial guess is exact and no iterations are needed.
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal2lkit/parsed_solver.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+int
+main()
+{
+  initlog();
+
+  const unsigned int n = 10;
+  FullMatrix<double> A(n, n);
+  for (unsigned int i = 0; i < n; ++i)
+    {
+      A(i, i) = 2;
+      if (i > 0)
+        A(i, i - 1) = -1;
+      if (i < n - 1)
+        A(i, i + 1) = -1;
+    }
+
+  ParsedSolver<Vector<double>> solver("Solver", "cg", 100, 1e-12);
+  solver.op = linear_operator<Vector<double>>(A);
+
+  ParameterHandler prm;
+  dealii::ParameterAcceptor::declare_all_parameters(prm);
+  prm.parse_input_from_string("subsection Solver\n"
+                              "  set Initial guess = linear extrapolation\n"
+                              "  set Log result    = false\n"
+                              "end\n");
+  dealii::ParameterAcceptor::parse_all_parameters(prm);
+
+  solver.prec = identity_operator(solver.op);
+
+  Vector<double> b(n), x(n);
+  for (unsigned int i = 0; i < n; ++i)
+    b(i) = 1. + i;
+
+  for (unsigned int k = 0; k < 4; ++k)
+    {
+      Vector<double> rhs(b);
+      rhs *= (k + 1.);
+      if (k == 2)
+        solver.solve(x, rhs);
+      else
+        solver.vmult(x, rhs);
+
+      Vector<double> residual(n);
+      A.vmult(residual, x);
+      residual -= rhs;
+
+      deallog << "Solve " << k << ": converged "
+              << (residual.l2_norm() < 1e-8 * rhs.l2_norm())
+              << ", iterations " << (k < 2 ? "> 0 " : "= 0 ")
+              << (k < 2 ? solver.control.last_step() > 0 :
+                          solver.control.last_step() == 0)
+              << std::endl;
+    }
+}
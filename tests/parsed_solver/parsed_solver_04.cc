@@ -0,0 +1,87 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2015 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Solve a system in mixed precision, with the default single precision
+// operators, and with a single precision copy of the matrix. The
+// residual reaches a reduction which is not attainable in single
+// precision.
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal2lkit/parsed_solver.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+int
+main()
+{
+  initlog();
+
+  const unsigned int n = 50;
+  FullMatrix<double> A(n, n);
+  for (unsigned int i = 0; i < n; ++i)
+    {
+      A(i, i) = 2.1;
+      if (i > 0)
+        A(i, i - 1) = -1;
+      if (i < n - 1)
+        A(i, i + 1) = -1;
+    }
+  FullMatrix<float> A_float(n, n);
+  A_float = A;
+
+  ParsedSolver<Vector<double>> solver("Solver", "cg", 1000, 1e-13);
+  solver.op = linear_operator<Vector<double>>(A);
+
+  ParameterHandler prm;
+  dealii::ParameterAcceptor::declare_all_parameters(prm);
+  prm.parse_input_from_string("subsection Solver\n"
+                              "  set Mixed precision = true\n"
+                              "  set Tolerance       = 0\n"
+                              "  set Log result      = false\n"
+                              "end\n");
+  dealii::ParameterAcceptor::parse_all_parameters(prm);
+
+  solver.prec = identity_operator(solver.op);
+
+  Vector<double> b(n);
+  for (unsigned int i = 0; i < n; ++i)
+    b(i) = 1. + i;
+
+  for (unsigned int k = 0; k < 2; ++k)
+    {
+      if (k == 1)
+        {
+          solver.op_single   = linear_operator<Vector<float>>(A_float);
+          solver.prec_single = identity_operator(solver.op_single);
+        }
+
+      Vector<double> x(n);
+      solver.vmult(x, b);
+
+      Vector<double> residual(n);
+      A.vmult(residual, x);
+      residual -= b;
+
+      deallog << (k == 0 ? "Default operators" : "Single precision matrix")
+              << ": converged " << (residual.l2_norm() < 1e-12 * b.l2_norm())
+              << ", refinement steps " << (solver.control.last_step() > 1)
+              << std::endl;
+    }
+}
@@ -0,0 +1,93 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2015 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Solve a symmetric system with pipelined-cg, and a non symmetric one
+// with s-step gmres, both with a Jacobi preconditioner.
+
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal2lkit/parsed_solver.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+int
+main()
+{
+  initlog();
+
+  const unsigned int n = 100;
+  FullMatrix<double> A(n, n), B(n, n);
+  for (unsigned int i = 0; i < n; ++i)
+    {
+      A(i, i) = B(i, i) = 2.05 + 0.01 * (i % 5);
+      if (i > 0)
+        {
+          A(i, i - 1) = -1;
+          B(i, i - 1) = -1.2;
+        }
+      if (i < n - 1)
+        {
+          A(i, i + 1) = -1;
+          B(i, i + 1) = -0.8;
+        }
+    }
+
+  ParsedSolver<Vector<double>> cg("Pipelined", "pipelined-cg", 1000, 1e-10);
+  ParsedSolver<Vector<double>> gmres("S-step", "s-step gmres", 1000, 1e-10);
+
+  ParameterHandler prm;
+  dealii::ParameterAcceptor::declare_all_parameters(prm);
+  prm.parse_input_from_string("subsection Pipelined\n"
+                              "  set Log result = false\n"
+                              "end\n"
+                              "subsection S-step\n"
+                              "  set Log result  = false\n"
+                              "  set S-step size = 6\n"
+                              "end\n");
+  dealii::ParameterAcceptor::parse_all_parameters(prm);
+
+  DiagonalMatrix<Vector<double>> jacobi;
+  jacobi.get_vector().reinit(n);
+  for (unsigned int i = 0; i < n; ++i)
+    jacobi.get_vector()(i) = 1. / A(i, i);
+
+  Vector<double> b(n);
+  for (unsigned int i = 0; i < n; ++i)
+    b(i) = 1. + i % 7;
+
+  for (unsigned int k = 0; k < 2; ++k)
+    {
+      const FullMatrix<double> &   M      = (k == 0 ? A : B);
+      ParsedSolver<Vector<double>> &solver = (k == 0 ? cg : gmres);
+
+      solver.op   = linear_operator<Vector<double>>(M);
+      solver.prec = linear_operator<Vector<double>>(M, jacobi);
+
+      Vector<double> x(n);
+      solver.vmult(x, b);
+
+      Vector<double> residual(n);
+      M.vmult(residual, x);
+      residual -= b;
+
+      deallog << (k == 0 ? "pipelined-cg" : "s-step gmres") << ": converged "
+              << (residual.l2_norm() < 1e-9 * b.l2_norm()) << std::endl;
+    }
+}
@@ -0,0 +1,93 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2015 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Choose between richardson, which does not converge, and cg with the
+// auto solver. The choice is written to a file, and read back when the
+// parameters are parsed again, without tuning again.
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal2lkit/parsed_solver.h>
+
+#include "../tests.h"
+
+#include <cstdio>
+
+
+using namespace deal2lkit;
+
+int
+main()
+{
+  initlog();
+
+  std::remove("auto_tuning.txt");
+
+  const unsigned int n = 20;
+  FullMatrix<double> A(n, n);
+  for (unsigned int i = 0; i < n; ++i)
+    {
+      A(i, i) = 2.05;
+      if (i > 0)
+        A(i, i - 1) = -1;
+      if (i < n - 1)
+        A(i, i + 1) = -1;
+    }
+
+  ParsedSolver<Vector<double>> solver("Solver", "auto", 100, 1e-10);
+  solver.op = linear_operator<Vector<double>>(A);
+
+  ParameterHandler prm;
+  dealii::ParameterAcceptor::declare_all_parameters(prm);
+  prm.parse_input_from_string("subsection Solver\n"
+                              "  set Auto candidates    = richardson, cg\n"
+                              "  set Auto tuning file   = auto_tuning.txt\n"
+                              "  set Auto tuning solves = 2\n"
+                              "  set Log result         = false\n"
+                              "end\n");
+  dealii::ParameterAcceptor::parse_all_parameters(prm);
+
+  solver.prec = identity_operator(solver.op);
+
+  Vector<double> b(n);
+  for (unsigned int i = 0; i < n; ++i)
+    b(i) = 1. + i;
+
+  for (unsigned int k = 0; k < 4; ++k)
+    {
+      if (k == 3)
+        {
+          deallog << "Parse again" << std::endl;
+          dealii::ParameterAcceptor::parse_all_parameters(prm);
+        }
+
+      Vector<double> x(n);
+      solver.vmult(x, b);
+
+      Vector<double> residual(n);
+      A.vmult(residual, x);
+      residual -= b;
+
+      deallog << "Solve " << k << ": converged "
+              << (residual.l2_norm() < 1e-8 * b.l2_norm()) << std::endl;
+    }
+
+  std::ifstream in("auto_tuning.txt");
+  std::string   line;
+  while (std::getline(in, line))
+    if (line[0] != '#')
+      deallog << line << std::endl;
+}
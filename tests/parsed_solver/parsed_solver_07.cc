@@ -0,0 +1,98 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2015 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Solve a sequence of systems with the same operator and different
+// right hand sides with the deflated-cg solver, counting the
+// applications of the operator. When the operator is declared
+// constant, the products with the recycled subspace are reused, and
+// every solve applies the operator once per iteration plus once for
+// the initial residual. Otherwise, they are recomputed at every solve.
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal2lkit/parsed_solver.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+int
+main()
+{
+  initlog();
+
+  const unsigned int n = 100;
+  FullMatrix<double> A(n, n);
+  for (unsigned int i = 0; i < n; ++i)
+    {
+      A(i, i) = 2. + 1e-3 * (1 + i % 3);
+      if (i > 0)
+        A(i, i - 1) = -1;
+      if (i < n - 1)
+        A(i, i + 1) = -1;
+    }
+
+  unsigned int applications = 0;
+  auto         op           = linear_operator<Vector<double>>(A);
+  op.vmult = [&](Vector<double> &dst, const Vector<double> &src) {
+    ++applications;
+    A.vmult(dst, src);
+  };
+
+  ParsedSolver<Vector<double>> constant("Constant", "deflated-cg", 1000, 1e-10);
+  ParsedSolver<Vector<double>> varying("Varying", "deflated-cg", 1000, 1e-10);
+
+  ParameterHandler prm;
+  dealii::ParameterAcceptor::declare_all_parameters(prm);
+  prm.parse_input_from_string("subsection Constant\n"
+                              "  set Recycled operator is constant = true\n"
+                              "  set Log result                    = false\n"
+                              "end\n"
+                              "subsection Varying\n"
+                              "  set Log result                    = false\n"
+                              "end\n");
+  dealii::ParameterAcceptor::parse_all_parameters(prm);
+
+  const auto run = [&](const std::string &            name,
+                       ParsedSolver<Vector<double>> &solver) {
+    solver.op   = op;
+    solver.prec = identity_operator(op);
+
+    for (unsigned int k = 0; k < 4; ++k)
+      {
+        Vector<double> b(n), x(n);
+        for (unsigned int i = 0; i < n; ++i)
+          b(i) = 1. + std::sin(1. * (i + k));
+
+        applications = 0;
+        solver.vmult(x, b);
+
+        Vector<double> residual(n);
+        A.vmult(residual, x);
+        residual -= b;
+
+        const unsigned int iterations = solver.control.last_step();
+        deallog << name << " solve " << k << ": converged "
+                << (residual.l2_norm() < 1e-8 * b.l2_norm())
+                << ", extra applications " << (applications > iterations + 1)
+                << std::endl;
+      }
+  };
+
+  run("Constant", constant);
+  run("Varying", varying);
+}
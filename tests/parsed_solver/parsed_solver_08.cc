@@ -0,0 +1,101 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2015 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Compute fused scalar products of distributed Trilinos vectors, which
+// use a single non-blocking reduction, and solve a distributed system
+// with pipelined-cg on Trilinos vectors.
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/mpi.h>
+
+#include <deal.II/lac/trilinos_sparse_matrix.h>
+#include <deal.II/lac/trilinos_vector.h>
+
+#include <deal2lkit/fused_dot_products.h>
+#include <deal2lkit/parsed_solver.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, numbers::invalid_unsigned_int);
+  mpi_initlog();
+
+  using VEC = TrilinosWrappers::MPI::Vector;
+
+  const unsigned int n       = 100;
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+  const unsigned int rank    = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+
+  IndexSet owned(n);
+  owned.add_range(rank * n / n_procs, (rank + 1) * n / n_procs);
+  owned.compress();
+
+  VEC a(owned, MPI_COMM_WORLD), b(owned, MPI_COMM_WORLD);
+  for (const auto i : owned)
+    {
+      a[i] = 1. + std::sin(1. * i);
+      b[i] = 1. + std::cos(1. * i);
+    }
+  a.compress(VectorOperation::insert);
+  b.compress(VectorOperation::insert);
+
+  FusedDotProducts<VEC> dots;
+  dots.add(a, b);
+  dots.add(a, a);
+  dots.start();
+  const std::vector<double> results = dots.finish();
+
+  deallog << "Fused a*b: " << (std::abs(results[0] - a * b) < 1e-12 * n)
+          << std::endl;
+  deallog << "Fused a*a: " << (std::abs(results[1] - a * a) < 1e-12 * n)
+          << std::endl;
+
+  TrilinosWrappers::SparseMatrix A(owned, MPI_COMM_WORLD, 3);
+  for (const auto i : owned)
+    {
+      A.set(i, i, 2.05 + 0.01 * (i % 5));
+      if (i > 0)
+        A.set(i, i - 1, -1.);
+      if (i < n - 1)
+        A.set(i, i + 1, -1.);
+    }
+  A.compress(VectorOperation::insert);
+
+  ParsedSolver<VEC> solver("Solver", "pipelined-cg", 1000, 1e-10);
+
+  ParameterHandler prm;
+  dealii::ParameterAcceptor::declare_all_parameters(prm);
+  prm.parse_input_from_string("subsection Solver\n"
+                              "  set Log result = false\n"
+                              "end\n");
+  dealii::ParameterAcceptor::parse_all_parameters(prm);
+
+  solver.op   = linear_operator<VEC>(A);
+  solver.prec = identity_operator(solver.op);
+
+  VEC x(owned, MPI_COMM_WORLD), residual(owned, MPI_COMM_WORLD);
+  solver.vmult(x, a);
+
+  A.vmult(residual, x);
+  residual -= a;
+  deallog << "pipelined-cg: converged "
+          << (residual.l2_norm() < 1e-8 * a.l2_norm()) << std::endl;
+}
@@ -0,0 +1,87 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2015 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Let the auto solver choose deflated-cg, and solve a sequence of
+// slowly varying systems with it. The chosen solver is initialized only
+// once, so that the recycled subspace survives between the solves, and
+// the solver needs fewer iterations than at the first solve.
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal2lkit/parsed_solver.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+int
+main()
+{
+  initlog();
+
+  const unsigned int n = 100;
+  FullMatrix<double> A(n, n);
+
+  ParsedSolver<Vector<double>> solver("Solver", "auto", 1000, 1e-10);
+  solver.op = linear_operator<Vector<double>>(A);
+
+  ParameterHandler prm;
+  dealii::ParameterAcceptor::declare_all_parameters(prm);
+  prm.parse_input_from_string("subsection Solver\n"
+                              "  set Auto candidates    = deflated-cg\n"
+                              "  set Auto tuning solves = 1\n"
+                              "  set Log result         = false\n"
+                              "end\n");
+  dealii::ParameterAcceptor::parse_all_parameters(prm);
+
+  solver.prec = identity_operator(solver.op);
+
+  unsigned int first_iterations = 0;
+  for (unsigned int k = 0; k < 4; ++k)
+    {
+      A = 0;
+      for (unsigned int i = 0; i < n; ++i)
+        {
+          A(i, i) = 2. + 1e-3 * k * (1 + i % 3);
+          if (i > 0)
+            A(i, i - 1) = -1;
+          if (i < n - 1)
+            A(i, i + 1) = -1;
+        }
+
+      Vector<double> b(n), x(n);
+      for (unsigned int i = 0; i < n; ++i)
+        b(i) = 1. + std::sin(1. * (i + k));
+
+      solver.vmult(x, b);
+
+      Vector<double> residual(n);
+      A.vmult(residual, x);
+      residual -= b;
+
+      const unsigned int iterations = solver.control.last_step();
+      if (k == 0)
+        first_iterations = iterations;
+
+      deallog << "Solve " << k << ": converged "
+              << (residual.l2_norm() < 1e-8 * b.l2_norm());
+      if (k > 0)
+        deallog << ", fewer iterations "
+                << (4 * iterations < 3 * first_iterations);
+      deallog << std::endl;
+    }
+}
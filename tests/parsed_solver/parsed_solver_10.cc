@@ -0,0 +1,83 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2015 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Solve with the deflated-cg solver and a constant operator, then
+// replace the operator through set_operator() with a slightly shifted
+// one. The recycled subspace must be discarded, so that the following
+// solves are not deflated with the products of the old operator.
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal2lkit/parsed_solver.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+int
+main()
+{
+  initlog();
+
+  const unsigned int n = 100;
+  FullMatrix<double> A(n, n), B(n, n);
+  for (unsigned int i = 0; i < n; ++i)
+    {
+      A(i, i) = 2. + 1e-3 * (1 + i % 3);
+      if (i > 0)
+        A(i, i - 1) = -1;
+      if (i < n - 1)
+        A(i, i + 1) = -1;
+    }
+  B.copy_from(A);
+  B.diagadd(1e-2);
+
+  ParsedSolver<Vector<double>> solver("Solver", "deflated-cg", 1000, 1e-10);
+
+  ParameterHandler prm;
+  dealii::ParameterAcceptor::declare_all_parameters(prm);
+  prm.parse_input_from_string("subsection Solver\n"
+                              "  set Recycled operator is constant = true\n"
+                              "  set Log result                    = false\n"
+                              "end\n");
+  dealii::ParameterAcceptor::parse_all_parameters(prm);
+
+  const auto solve = [&](const std::string &name, const FullMatrix<double> &M) {
+    for (unsigned int k = 0; k < 2; ++k)
+      {
+        Vector<double> b(n), x(n);
+        for (unsigned int i = 0; i < n; ++i)
+          b(i) = 1. + std::sin(1. * (i + k));
+
+        solver.vmult(x, b);
+
+        Vector<double> residual(n);
+        M.vmult(residual, x);
+        residual -= b;
+
+        deallog << name << " solve " << k << ": converged "
+                << (residual.l2_norm() < 1e-8 * b.l2_norm()) << std::endl;
+      }
+  };
+
+  solver.set_operator(linear_operator<Vector<double>>(A));
+  solver.prec = identity_operator(solver.op);
+  solve("A", A);
+
+  solver.set_operator(linear_operator<Vector<double>>(B));
+  solve("B", B);
+}
@@ -0,0 +1,112 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// test the zero average projection: no constraint is added, the
+// projected vector has zero mean value, and the constants of the
+// constrained component are in the kernel of the projection
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/linear_operator.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include <deal2lkit/parsed_zero_average_constraints.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+template <int dim>
+void
+test()
+{
+  Triangulation<dim> tr;
+  GridGenerator::hyper_cube(tr);
+  tr.refine_global(2);
+
+  FESystem<dim>   fe(FE_Q<dim>(2), dim, FE_Q<dim>(1), 1);
+  DoFHandler<dim> dof(tr);
+  dof.distribute_dofs(fe);
+
+  deallog << "FE=" << fe.get_name() << std::endl;
+
+  ParsedZeroAverageConstraints<dim> pnac("Parsed Zero Average Constraints",
+                                         dim + 1,
+                                         (dim == 2 ? "u,u,p" : "u,u,u,p"),
+                                         "p");
+
+  dealii::ParameterAcceptor::initialize(
+    SOURCE_DIR "/parameters/parsed_zero_average_constraints_05.prm",
+    "used_parameters.prm");
+
+  AffineConstraints<double> cm;
+  pnac.apply_zero_average_constraints(dof, cm);
+  deallog << "Number of constraints: " << cm.n_constraints() << std::endl;
+
+  pnac.compute_mean_value_projection(dof);
+
+  const auto identity = identity_operator<Vector<double>>(
+    [&dof](Vector<double> &v, bool omit_zeroing_entries) {
+      v.reinit(dof.n_dofs(), omit_zeroing_entries);
+    });
+  const auto P = pnac.mean_value_projection(identity);
+
+  Vector<double> v(dof.n_dofs());
+  Vector<double> w(dof.n_dofs());
+  for (unsigned int i = 0; i < v.size(); ++i)
+    v(i) = 1.0 + (i % 7);
+
+  P.vmult(w, v);
+  const double mean =
+    VectorTools::compute_mean_value(dof, QGauss<dim>(3), w, dim);
+  deallog << "Zero mean value: " << (std::abs(mean) < 1e-10) << std::endl;
+
+  std::vector<bool> m(dim + 1, false);
+  m[dim]                  = true;
+  const IndexSet pressure = DoFTools::extract_dofs(dof, ComponentMask(m));
+
+  Vector<double> one(dof.n_dofs());
+  for (auto i : pressure)
+    one(i) = 1.0;
+
+  P.vmult(w, one);
+  deallog << "Constants in the kernel: " << (w.l2_norm() < 1e-10)
+          << std::endl;
+
+  P.Tvmult(w, v);
+  deallog << "Transpose orthogonal to the constants: "
+          << (std::abs(w * one) < 1e-10) << std::endl;
+}
+
+
+int
+main()
+{
+  initlog();
+
+  test<2>();
+}
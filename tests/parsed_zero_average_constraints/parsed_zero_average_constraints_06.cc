@@ -0,0 +1,168 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2015 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// solve a pure Neumann problem on a distributed triangulation through
+// the zero average operator: the right hand side is not compatible, no
+// constraint is added to the sparse matrix, and the solution must have
+// zero mean value and approximate the exact solution with zero mean
+
+#include <deal.II/base/function.h>
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/linear_operator.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/sparsity_tools.h>
+#include <deal.II/lac/trilinos_precondition.h>
+#include <deal.II/lac/trilinos_sparse_matrix.h>
+#include <deal.II/lac/trilinos_vector.h>
+
+#include <deal.II/numerics/matrix_tools.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include <deal2lkit/parsed_zero_average_constraints.h>
+
+#include "../tests.h"
+
+
+using namespace deal2lkit;
+
+typedef TrilinosWrappers::MPI::Vector VEC;
+
+/**
+ * The exact solution, which has zero mean value on the unit square.
+ */
+class ExactSolution : public Function<2>
+{
+public:
+  virtual double
+  value(const Point<2> &p, const unsigned int = 0) const override
+  {
+    return std::cos(numbers::PI * p[0]) * std::cos(numbers::PI * p[1]);
+  }
+};
+
+/**
+ * The right hand side of the exact solution, plus a constant which
+ * makes the problem incompatible.
+ */
+class RightHandSide : public Function<2>
+{
+public:
+  virtual double
+  value(const Point<2> &p, const unsigned int = 0) const override
+  {
+    return 2 * numbers::PI * numbers::PI * exact.value(p) + 1.0;
+  }
+
+private:
+  ExactSolution exact;
+};
+
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, numbers::invalid_unsigned_int);
+
+  mpi_initlog();
+
+  ParsedZeroAverageConstraints<2> pnac("Zero average", 1, "u", "u");
+
+  ParameterHandler prm;
+  dealii::ParameterAcceptor::declare_all_parameters(prm);
+  prm.parse_input_from_string("subsection Zero average\n"
+                              "  set Zero average method = projection\n"
+                              "end\n");
+  dealii::ParameterAcceptor::parse_all_parameters(prm);
+
+  parallel::distributed::Triangulation<2> tria(MPI_COMM_WORLD);
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(5);
+
+  FE_Q<2>       fe(2);
+  DoFHandler<2> dh(tria);
+  dh.distribute_dofs(fe);
+
+  IndexSet relevant_dofs;
+  DoFTools::extract_locally_relevant_dofs(dh, relevant_dofs);
+  DynamicSparsityPattern dsp(relevant_dofs);
+  DoFTools::make_sparsity_pattern(dh, dsp);
+  SparsityTools::distribute_sparsity_pattern(dsp,
+                                             dh.locally_owned_dofs(),
+                                             MPI_COMM_WORLD,
+                                             relevant_dofs);
+
+  AffineConstraints<double> constraints;
+  pnac.apply_zero_average_constraints(dh, constraints);
+  deallog << "Number of constraints: " << constraints.n_constraints()
+          << std::endl;
+
+  TrilinosWrappers::SparseMatrix matrix;
+  matrix.reinit(dh.locally_owned_dofs(),
+                dh.locally_owned_dofs(),
+                dsp,
+                MPI_COMM_WORLD);
+  MatrixCreator::create_laplace_matrix(dh, QGauss<2>(3), matrix);
+
+  VEC rhs(dh.locally_owned_dofs(), MPI_COMM_WORLD);
+  VectorTools::create_right_hand_side(dh,
+                                      QGauss<2>(3),
+                                      RightHandSide(),
+                                      rhs);
+
+  pnac.compute_mean_value_projection(dh);
+
+  TrilinosWrappers::PreconditionJacobi jacobi;
+  jacobi.initialize(matrix);
+
+  SolverControl control(1000, 1e-12);
+  SolverCG<VEC> cg(control);
+
+  const auto A    = linear_operator<VEC>(matrix);
+  const auto Ainv = inverse_operator(A, cg, jacobi);
+
+  VEC solution(rhs);
+  solution = pnac.zero_average_operator(Ainv) * rhs;
+
+  VEC ghosted(dh.locally_owned_dofs(), relevant_dofs, MPI_COMM_WORLD);
+  ghosted = solution;
+
+  const double mean =
+    VectorTools::compute_mean_value(dh, QGauss<2>(3), ghosted, 0);
+  deallog << "Zero mean value: " << (std::abs(mean) < 1e-10) << std::endl;
+
+  Vector<float> difference(tria.n_active_cells());
+  VectorTools::integrate_difference(dh,
+                                    ghosted,
+                                    ExactSolution(),
+                                    difference,
+                                    QGauss<2>(4),
+                                    VectorTools::L2_norm);
+  const double error =
+    VectorTools::compute_global_error(tria, difference, VectorTools::L2_norm);
+  deallog << "Exact solution recovered: " << (error < 1e-3) << std::endl;
+}
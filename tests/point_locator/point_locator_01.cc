@@ -0,0 +1,105 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Evaluate a Q2 function at a few points with PointLocator, refine the
+// mesh and evaluate again, and check that a point outside the mesh
+// throws an exception.
+
+#include <deal.II/base/function_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include <deal2lkit/point_locator.h>
+
+#include "../tests.h"
+
+using namespace deal2lkit;
+
+template <int dim>
+class TestFunction : public Function<dim>
+{
+public:
+  virtual double
+  value(const Point<dim> &p, const unsigned int = 0) const
+  {
+    return p[0] * p[0] + p[1];
+  }
+};
+
+template <int dim>
+void
+test()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(2);
+
+  FE_Q<dim>       fe(2);
+  DoFHandler<dim> dh(tria);
+
+  PointLocator<dim> locator(dh);
+
+  std::vector<Point<dim>> points(3);
+  for (unsigned int d = 0; d < dim; ++d)
+    {
+      points[0][d] = 0.1;
+      points[1][d] = 0.5;
+      points[2][d] = 1.0 - d * 0.3;
+    }
+
+  for (unsigned int cycle = 0; cycle < 2; ++cycle)
+    {
+      if (cycle > 0)
+        tria.refine_global(1);
+
+      dh.distribute_dofs(fe);
+      Vector<double> solution(dh.n_dofs());
+      VectorTools::interpolate(dh, TestFunction<dim>(), solution);
+
+      const auto values = locator.evaluate(points, solution);
+      for (unsigned int i = 0; i < points.size(); ++i)
+        deallog << "Cycle " << cycle << ", point " << points[i] << ": "
+                << values[i][0] << std::endl;
+    }
+
+  try
+    {
+      locator.evaluate(std::vector<Point<dim>>(1, Point<dim>::unit_vector(0) *
+                                                    2.0),
+                       Vector<double>(dh.n_dofs()));
+    }
+  catch (const typename PointLocator<dim>::ExcPointNotFound &)
+    {
+      deallog << "Point outside the mesh not found." << std::endl;
+    }
+}
+
+int
+main()
+{
+  initlog();
+  deallog << std::fixed << std::setprecision(4);
+  test<2>();
+  test<3>();
+}
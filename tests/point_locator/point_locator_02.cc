@@ -0,0 +1,111 @@
+//-----------------------------------------------------------
+//
+//    Copyright (C) 2016 by the deal2lkit authors
+//
+//    This file is part of the deal2lkit library.
+//
+//    The deal2lkit library is free software; you can use it, redistribute
+//    it, and/or modify it under the terms of the GNU Lesser General
+//    Public License as published by the Free Software Foundation; either
+//    version 2.1 of the License, or (at your option) any later version.
+//    The full text of the license can be found in the file LICENSE at
+//    the top level of the deal2lkit distribution.
+//
+//-----------------------------------------------------------
+
+// Evaluate a Q2 function with PointLocator on a distributed
+// triangulation, and check that every point inside the mesh is located
+// by exactly one process, also on the interface between the processes.
+
+#include <deal.II/base/function_lib.h>
+#include <deal.II/base/mpi.h>
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include <deal2lkit/point_locator.h>
+
+#include "../tests.h"
+
+using namespace deal2lkit;
+
+template <int dim>
+class TestFunction : public Function<dim>
+{
+public:
+  virtual double
+  value(const Point<dim> &p, const unsigned int = 0) const
+  {
+    return p[0] * p[0] + p[1];
+  }
+};
+
+template <int dim>
+void
+test()
+{
+  parallel::distributed::Triangulation<dim> tria(MPI_COMM_WORLD);
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(3);
+
+  FE_Q<dim>       fe(2);
+  DoFHandler<dim> dh(tria);
+  dh.distribute_dofs(fe);
+
+  IndexSet relevant_dofs;
+  DoFTools::extract_locally_relevant_dofs(dh, relevant_dofs);
+  LinearAlgebra::distributed::Vector<double> solution(dh.locally_owned_dofs(),
+                                                      relevant_dofs,
+                                                      MPI_COMM_WORLD);
+  VectorTools::interpolate(dh, TestFunction<dim>(), solution);
+  solution.update_ghost_values();
+
+  // The points with x = 0.5 lie on the interface between the two
+  // processes, the last one is outside the mesh.
+  std::vector<Point<dim>> points(4);
+  for (unsigned int d = 0; d < dim; ++d)
+    {
+      points[0][d] = 0.1;
+      points[1][d] = 0.5;
+      points[2][d] = 0.9 - d * 0.3;
+      points[3][d] = 2.0;
+    }
+
+  PointLocator<dim> locator(dh);
+  const auto        located = locator.locate(points);
+
+  for (unsigned int i = 0; i < points.size(); ++i)
+    {
+      const unsigned int n_owners = Utilities::MPI::sum(
+        (located[i].first != dh.end() ? 1u : 0u), MPI_COMM_WORLD);
+      deallog << "Point " << points[i] << " located by " << n_owners
+              << " process(es)" << std::endl;
+    }
+
+  points.pop_back();
+  const auto values = locator.evaluate(points, solution);
+  for (unsigned int i = 0; i < points.size(); ++i)
+    deallog << "Point " << points[i] << ": " << values[i][0] << std::endl;
+}
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, numbers::invalid_unsigned_int);
+  mpi_initlog();
+  deallog << std::fixed << std::setprecision(4);
+
+  test<2>();
+  test<3>();
+}